@@ -209,57 +209,7 @@ ui64 evaluateDanger(crint3 tile)
 
 ui64 evaluateDanger(crint3 tile, const CGHeroInstance *visitor)
 {
-	const TerrainTile *t = cb->getTile(tile, false);
-	if(!t) //we can know about guard but can't check its tile (the edge of fow)
-		return 190000000; //MUCH
-
-	ui64 objectDanger = 0, guardDanger = 0;
-
-	auto visitableObjects = cb->getVisitableObjs(tile);
-	// in some scenarios hero happens to be "under" the object (eg town). Then we consider ONLY the hero.
-	if(vstd::contains_if(visitableObjects, objWithID<Obj::HERO>))
-		vstd::erase_if(visitableObjects, [](const CGObjectInstance * obj)
-		{
-			return !objWithID<Obj::HERO>(obj);
-		});
-
-	if(const CGObjectInstance * dangerousObject = vstd::backOrNull(visitableObjects))
-	{
-		objectDanger = evaluateDanger(dangerousObject); //unguarded objects can also be dangerous or unhandled
-		if (objectDanger)
-		{
-			//TODO: don't downcast objects AI shouldn't know about!
-			auto armedObj = dynamic_cast<const CArmedInstance*>(dangerousObject);
-			if (armedObj)
-			{
-				float tacticalAdvantage = fh->getTacticalAdvantage(visitor, armedObj);
-				objectDanger *= tacticalAdvantage; //this line tends to go infinite for allied towns (?)
-			}
-		}
-		if (dangerousObject->ID == Obj::SUBTERRANEAN_GATE)
-		{ //check guard on the other side of the gate
-			auto it = ai->knownSubterraneanGates.find(dangerousObject);
-			if (it != ai->knownSubterraneanGates.end())
-			{
-				auto guards = cb->getGuardingCreatures(it->second->visitablePos());
-				for (auto cre : guards)
-				{
-					vstd::amax (guardDanger, evaluateDanger(cre) *
-						fh->getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance*>(cre)));
-				}
-			}
-		}
-	}
-
-	auto guards = cb->getGuardingCreatures(tile);
-	for (auto cre : guards)
-	{
-		vstd::amax (guardDanger, evaluateDanger(cre) * fh->getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance*>(cre))); //we are interested in strongest monster around
-	}
-
-
-	//TODO mozna odwiedzic blockvis nie ruszajac straznika
-	return std::max(objectDanger, guardDanger);
+	return ai->dangerMap.getDanger(tile, visitor);
 }
 
 ui64 evaluateDanger(const CGObjectInstance *obj)
@@ -319,6 +269,236 @@ ui64 evaluateDanger(const CGObjectInstance *obj)
 	}
 }
 
+const ui64 DangerMap::UNKNOWN;
+
+size_t DangerMap::tileIndex(const int3 & tile) const
+{
+	return (tile.z * sizes.y + tile.y) * sizes.x + tile.x;
+}
+
+void DangerMap::reset()
+{
+	sizes = cb->getMapSize();
+	threats.clear();
+	threats.resize(sizes.x * sizes.y * sizes.z);
+	heroes.clear();
+}
+
+void DangerMap::evaluateThreats(const int3 & tile, TileThreats & out) const
+{
+	out = TileThreats();
+	out.valid = true;
+	out.visible = cb->getTile(tile, false) != nullptr;
+	if(!out.visible)
+		return;
+
+	auto visitableObjects = cb->getVisitableObjs(tile);
+	// in some scenarios hero happens to be "under" the object (eg town). Then we consider ONLY the hero.
+	if(vstd::contains_if(visitableObjects, objWithID<Obj::HERO>))
+		vstd::erase_if(visitableObjects, [](const CGObjectInstance * obj)
+		{
+			return !objWithID<Obj::HERO>(obj);
+		});
+
+	if(const CGObjectInstance * dangerousObject = vstd::backOrNull(visitableObjects))
+	{
+		out.object = dangerousObject;
+		out.objectDanger = ::evaluateDanger(dangerousObject); //unguarded objects can also be dangerous or unhandled
+		if (dangerousObject->ID == Obj::SUBTERRANEAN_GATE)
+		{ //check guard on the other side of the gate
+			auto it = ai->knownSubterraneanGates.find(dangerousObject);
+			if (it != ai->knownSubterraneanGates.end())
+			{
+				for (auto cre : cb->getGuardingCreatures(it->second->visitablePos()))
+					out.guards.push_back(std::make_pair(cre, ::evaluateDanger(cre)));
+			}
+		}
+	}
+
+	for (auto cre : cb->getGuardingCreatures(tile))
+		out.guards.push_back(std::make_pair(cre, ::evaluateDanger(cre)));
+}
+
+ui64 DangerMap::evaluateDanger(const TileThreats & tileThreats, const CGHeroInstance * visitor) const
+{
+	if(!tileThreats.visible) //we can know about guard but can't check its tile (the edge of fow)
+		return 190000000; //MUCH
+
+	ui64 objectDanger = tileThreats.objectDanger, guardDanger = 0;
+
+	if (objectDanger)
+	{
+		//TODO: don't downcast objects AI shouldn't know about!
+		auto armedObj = dynamic_cast<const CArmedInstance*>(tileThreats.object);
+		if (armedObj)
+		{
+			float tacticalAdvantage = fh->getTacticalAdvantage(visitor, armedObj);
+			objectDanger *= tacticalAdvantage; //this line tends to go infinite for allied towns (?)
+		}
+	}
+
+	for (auto & guard : tileThreats.guards)
+	{
+		vstd::amax (guardDanger, guard.second * fh->getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance*>(guard.first))); //we are interested in strongest monster around
+	}
+
+	//TODO mozna odwiedzic blockvis nie ruszajac straznika
+	return std::max(objectDanger, guardDanger);
+}
+
+ui64 DangerMap::getDanger(const int3 & tile, const CGHeroInstance * visitor)
+{
+	if(!cb->isInTheMap(tile))
+		return 190000000; //MUCH
+	if(threats.empty())
+		reset();
+
+	const size_t index = tileIndex(tile);
+	TileThreats & tileThreats = threats.at(index);
+	if(!tileThreats.valid)
+		evaluateThreats(tile, tileThreats);
+
+	HeroDanger & heroDanger = heroes[visitor];
+	const ui64 armyStrength = visitor->getArmyStrength();
+	if(heroDanger.danger.empty() || heroDanger.armyStrength != armyStrength)
+	{
+		heroDanger.armyStrength = armyStrength;
+		heroDanger.danger.assign(threats.size(), UNKNOWN);
+	}
+
+	ui64 & danger = heroDanger.danger[index];
+	if(danger == UNKNOWN)
+		danger = evaluateDanger(tileThreats, visitor);
+	return danger;
+}
+
+void DangerMap::invalidateTile(const int3 & tile)
+{
+	if(!cb->isInTheMap(tile) || threats.empty())
+		return;
+
+	const size_t index = tileIndex(tile);
+	threats[index].valid = false;
+	for(auto & hero : heroes)
+	{
+		if(!hero.second.danger.empty())
+			hero.second.danger[index] = UNKNOWN;
+	}
+}
+
+void DangerMap::invalidate(const int3 & tile)
+{
+	// monsters guard surrounding tiles
+	invalidateTile(tile);
+	foreach_neighbour(tile, [this](const int3 & pos)
+	{
+		invalidateTile(pos);
+	});
+
+	// subterranean gate tile is also threatened by guards on the other side
+	for(auto & gate : ai->knownSubterraneanGates)
+	{
+		if(gate.second->visitablePos().areNeighbours(tile))
+			invalidateTile(gate.first->visitablePos());
+	}
+}
+
+void DangerMap::invalidate(const CGObjectInstance * obj)
+{
+	if(obj->isVisitable())
+		invalidate(obj->visitablePos());
+}
+
+void DangerMap::forgetHero(const CGHeroInstance * hero)
+{
+	heroes.erase(hero);
+}
+
+ExplorationFrontier::ExplorationFrontier()
+	: valid(false)
+{
+}
+
+void ExplorationFrontier::reset()
+{
+	valid = false;
+	tiles.clear();
+}
+
+void ExplorationFrontier::updateTile(CCallback * cbp, const int3 & tile)
+{
+	bool bordersFog = false;
+	if(cbp->isVisible(tile))
+	{
+		foreach_neighbour(cbp, tile, [&](CCallback * cbp, const int3 & neighbour)
+		{
+			if(!cbp->isVisible(neighbour))
+				bordersFog = true;
+		});
+	}
+
+	if(bordersFog)
+		tiles.insert(tile);
+	else
+		tiles.erase(tile);
+}
+
+void ExplorationFrontier::update(const std::unordered_set<int3, ShashInt3> & changedTiles)
+{
+	if(!valid)
+		return;
+
+	CCallback * cbp = cb.get();
+	for(const int3 & tile : changedTiles)
+	{
+		// visibility of tile affects frontier membership of its neighbours as well
+		updateTile(cbp, tile);
+		foreach_neighbour(cbp, tile, [this](CCallback * cbp, const int3 & neighbour)
+		{
+			updateTile(cbp, neighbour);
+		});
+	}
+}
+
+const std::unordered_set<int3, ShashInt3> & ExplorationFrontier::getTiles()
+{
+	if(!valid)
+	{
+		foreach_tile_pos(cb.get(), [this](CCallback * cbp, const int3 & pos)
+		{
+			updateTile(cbp, pos);
+		});
+		valid = true;
+	}
+	return tiles;
+}
+
+void ExplorationFrontier::getTilesNearFog(int radius, std::vector<std::vector<int3>> & out)
+{
+	out.clear();
+	if(radius < 2)
+		return;
+
+	CCallback * cbp = cb.get();
+	const auto & frontier = getTiles();
+
+	out.resize(radius - 1);
+	out[0].assign(frontier.begin(), frontier.end());
+
+	std::unordered_set<int3, ShashInt3> visited(frontier.begin(), frontier.end());
+	for(int i = 1; i < radius - 1; i++)
+	{
+		for(const int3 & tile : out[i - 1])
+		{
+			foreach_neighbour(cbp, tile, [&](CCallback * cbp, const int3 & neighbour)
+			{
+				if(cbp->isVisible(neighbour) && visited.insert(neighbour).second)
+					out[i].push_back(neighbour);
+			});
+		}
+	}
+}
+
 bool compareDanger(const CGObjectInstance *lhs, const CGObjectInstance *rhs)
 {
 	return evaluateDanger(lhs) < evaluateDanger(rhs);
@@ -342,14 +522,6 @@ bool isSafeToVisit(HeroPtr h, crint3 tile)
 	return true; //there's no danger
 }
 
-bool canBeEmbarkmentPoint(const TerrainTile *t, bool fromWater)
-{
-	//tile must be free of with unoccupied boat
-	return !t->blocked
-        || (!fromWater && t->visitableObjects.size() == 1 && t->topVisitableId() == Obj::BOAT);
-	//do not try to board when in water sector
-}
-
 int3 whereToExplore(HeroPtr h)
 {
 	TimeCheck tc ("where to explore");
@@ -452,18 +624,6 @@ int howManyTilesWillBeDiscovered(int radious, int3 pos, crint3 dir)
 	return howManyTilesWillBeDiscovered(pos + dir, radious, cb.get());
 }
 
-void getVisibleNeighbours(const std::vector<int3> &tiles, std::vector<int3> &out)
-{
-	for(const int3 &tile : tiles)
-	{
-		foreach_neighbour(tile, [&](int3 neighbour)
-		{
-			if(cb->isVisible(neighbour))
-				out.push_back(neighbour);
-		});
-	}
-}
-
 ui64 howManyReinforcementsCanGet(HeroPtr h, const CGTownInstance *t)
 {
 	ui64 ret = 0;
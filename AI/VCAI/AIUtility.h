@@ -142,9 +142,7 @@ void foreach_neighbour(CCallback * cbp, const int3 &pos, std::function<void(CCal
 
 int howManyTilesWillBeDiscovered(const int3 &pos, int radious, CCallback * cbp);
 int howManyTilesWillBeDiscovered(int radious, int3 pos, crint3 dir);
-void getVisibleNeighbours(const std::vector<int3> &tiles, std::vector<int3> &out);
 
-bool canBeEmbarkmentPoint(const TerrainTile *t, bool fromWater);
 bool isBlockedBorderGate(int3 tileToHit);
 bool isBlockVisitObj(const int3 &pos);
 
@@ -171,3 +169,67 @@ public:
 
 	bool operator ()(const CGObjectInstance *lhs, const CGObjectInstance *rhs);
 };
+
+/// Danger of map tiles for current turn, stored in flat per-tile arrays
+/// Threats of tile (dangerous object and guards) are shared by all heroes, final danger depends on visiting hero army.
+/// Both are evaluated on first lookup of a tile and invalidated when objects around tile change.
+class DangerMap
+{
+	static const ui64 UNKNOWN = std::numeric_limits<ui64>::max();
+
+	struct TileThreats
+	{
+		bool valid;
+		bool visible;
+		const CGObjectInstance * object; //object that would be fought when visiting tile
+		ui64 objectDanger;
+		std::vector<std::pair<const CGObjectInstance *, ui64>> guards; //monsters guarding tile and their strength
+
+		TileThreats() : valid(false), visible(false), object(nullptr), objectDanger(0) {}
+	};
+
+	struct HeroDanger
+	{
+		ui64 armyStrength; //danger depends on army, all tiles are evaluated again if it changes
+		std::vector<ui64> danger;
+	};
+
+	int3 sizes;
+	std::vector<TileThreats> threats;
+	std::map<const CGHeroInstance *, HeroDanger> heroes;
+
+	size_t tileIndex(const int3 & tile) const;
+	void evaluateThreats(const int3 & tile, TileThreats & out) const;
+	ui64 evaluateDanger(const TileThreats & tileThreats, const CGHeroInstance * visitor) const;
+	void invalidateTile(const int3 & tile);
+
+public:
+	/// Drops all evaluated tiles, should be called at start of turn
+	void reset();
+	/// Tile must be evaluated again together with tiles guarded from it
+	void invalidate(const int3 & tile);
+	void invalidate(const CGObjectInstance * obj);
+	void forgetHero(const CGHeroInstance * hero);
+
+	ui64 getDanger(const int3 & tile, const CGHeroInstance * visitor);
+};
+
+/// Visible tiles bordering fog of war, updated from visibility changes instead of scanning whole map
+class ExplorationFrontier
+{
+	bool valid;
+	std::unordered_set<int3, ShashInt3> tiles;
+
+	void updateTile(CCallback * cbp, const int3 & tile);
+
+public:
+	ExplorationFrontier();
+
+	/// Frontier will be collected from whole map on next use
+	void reset();
+	void update(const std::unordered_set<int3, ShashInt3> & changedTiles);
+
+	const std::unordered_set<int3, ShashInt3> & getTiles();
+	/// out[i] are visible tiles that are i+1 tiles away from fog, for i < radius - 1
+	void getTilesNearFog(int radius, std::vector<std::vector<int3>> & out);
+};
@@ -0,0 +1,361 @@
+/*
+ * SectorMap.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "SectorMap.h"
+
+#include "../../lib/CGameInfoCallback.h"
+#include "../../lib/CFogOfWarMap.h"
+#include "../../lib/mapping/CMapDefines.h"
+
+static const int FIRST_SECTOR = NOT_AVAILABLE + 1; //0 is invisible, 1 is not explored
+
+bool canBeEmbarkmentPoint(const TerrainTile *t, bool fromWater)
+{
+	//tile must be free of with unoccupied boat
+	return !t->blocked
+        || (!fromWater && t->visitableObjects.size() == 1 && t->topVisitableId() == Obj::BOAT);
+	//do not try to board when in water sector
+}
+
+SectorMap::SectorMap(CPlayerSpecificInfoCallback * cbp)
+	: cbp(cbp), valid(false), nextSectorId(FIRST_SECTOR), nextGeneration(1)
+{
+}
+
+bool SectorMap::markIfBlocked(TSectorID &sec, crint3 pos, const TerrainTile *t)
+{
+	if(t->blocked && !t->visitable)
+	{
+		sec = NOT_AVAILABLE;
+		return true;
+	}
+
+	return false;
+}
+
+bool SectorMap::markIfBlocked(TSectorID &sec, crint3 pos)
+{
+	return markIfBlocked(sec, pos, getTile(pos));
+}
+
+void SectorMap::update()
+{
+	if(!valid)
+		rebuild();
+	else if(!changedTiles.empty())
+		applyChanges();
+}
+
+void SectorMap::rebuild()
+{
+	visibleTiles = cbp->getAllVisibleTiles();
+	auto shape = visibleTiles->shape();
+	sizes = int3(shape[0], shape[1], shape[2]);
+	sector.resize(boost::extents[shape[0]][shape[1]][shape[2]]);
+	tileObjects.assign(sizes.x * sizes.y * sizes.z, nullptr);
+
+	infoOnSectors.clear();
+	freeSectorIds.clear();
+	heroParents.clear();
+	changedTiles.clear();
+	nextSectorId = FIRST_SECTOR;
+
+	clear();
+	std::set<int> adjacentSectors; //stays empty, neighbours of new sector are not explored yet
+	for(int z = 0; z < sizes.z; z++)
+		for(int x = 0; x < sizes.x; x++)
+			for(int y = 0; y < sizes.y; y++)
+			{
+				const int3 pos(x, y, z);
+				if(retreiveTile(pos) == NOT_CHECKED)
+				{
+					if(!markIfBlocked(retreiveTile(pos), pos))
+						exploreNewSector(pos, newSectorId(), adjacentSectors);
+				}
+			}
+	valid = true;
+}
+
+void SectorMap::applyChanges()
+{
+	std::vector<int3> contentChanged, explored;
+	std::set<int> lostTile;
+
+	for(const int3 & pos : changedTiles)
+	{
+		TerrainTile * t = const_cast<TerrainTile *>(cbp->getTile(pos, false));
+		(*visibleTiles)[pos.x][pos.y][pos.z] = t;
+
+		TSectorID sec = retreiveTile(pos);
+		if(sec >= FIRST_SECTOR && t && !(t->blocked && !t->visitable))
+			contentChanged.push_back(pos); //still part of sector, only object may differ
+		else if(sec >= FIRST_SECTOR)
+			lostTile.insert(sec);
+		explored.push_back(pos);
+	}
+
+	//sector may split into several ones, explore all its tiles again
+	for(int id : lostTile)
+	{
+		for(auto & tile : infoOnSectors.at(id).tiles)
+		{
+			retreiveTile(tile) = NOT_CHECKED;
+			tileObjects[tileIndex(tile)] = nullptr;
+			explored.push_back(tile);
+		}
+		releaseSector(id);
+	}
+
+	for(auto & pos : contentChanged)
+	{
+		const TSectorID sec = retreiveTile(pos);
+		if(sec < FIRST_SECTOR)
+			continue; //whole sector is explored again
+
+		Sector & s = infoOnSectors.at(sec);
+		const CGObjectInstance *& obj = tileObjects[tileIndex(pos)];
+		if(obj)
+		{
+			vstd::erase_if_present(s.visitableObjs, obj);
+			obj = nullptr;
+		}
+		const TerrainTile * t = getTile(pos);
+		if(t->visitable)
+			addVisitableObj(s, pos, t);
+		s.generation = nextGeneration++;
+	}
+
+	for(auto & pos : changedTiles)
+	{
+		TSectorID & sec = retreiveTile(pos);
+		if(sec < FIRST_SECTOR)
+			sec = getTile(pos) ? NOT_CHECKED : NOT_VISIBLE;
+	}
+
+	for(auto & pos : explored)
+	{
+		if(retreiveTile(pos) == NOT_CHECKED && !markIfBlocked(retreiveTile(pos), pos))
+		{
+			std::set<int> adjacentSectors;
+			int id = newSectorId();
+			exploreNewSector(pos, id, adjacentSectors);
+			for(int adjacent : adjacentSectors)
+				id = mergeSectors(id, adjacent);
+		}
+	}
+
+	for(auto & pos : changedTiles)
+		updateEmbarkmentPoint(pos);
+
+	changedTiles.clear();
+}
+
+void SectorMap::invalidate()
+{
+	valid = false;
+}
+
+void SectorMap::invalidate(crint3 pos)
+{
+	if(valid && cbp->isInTheMap(pos))
+		changedTiles.insert(pos);
+}
+
+void SectorMap::invalidate(const CGObjectInstance * obj)
+{
+	for(auto & pos : obj->getBlockedPos())
+		invalidate(pos);
+	invalidate(obj->visitablePos());
+}
+
+void SectorMap::forgetHero(const CGHeroInstance * h)
+{
+	heroParents.erase(h);
+}
+
+SectorMap::TSectorID &SectorMap::retreiveTileN(SectorMap::TSectorArray &a, const int3 &pos)
+{
+	return a[pos.x][pos.y][pos.z];
+}
+
+const SectorMap::TSectorID &SectorMap::retreiveTileN(const SectorMap::TSectorArray &a, const int3 &pos)
+{
+	return a[pos.x][pos.y][pos.z];
+}
+
+void SectorMap::clear()
+{
+	//TODO: rotate to [z][x][y]
+	const auto & fow = cbp->getVisibilityMap();
+	const int3 sizes = fow.getSizes();
+	for (int x = 0; x < sizes.x; x++)
+		for (int y = 0; y < sizes.y; y++ )
+			for (int z = 0; z < sizes.z; z++)
+				sector[x][y][z] = fow.isVisible(int3(x, y, z));
+	valid = false;
+}
+
+void SectorMap::exploreNewSector(crint3 pos, int num, std::set<int> & adjacentSectors)
+{
+	Sector &s = infoOnSectors[num];
+	s.id = num;
+	s.generation = nextGeneration++;
+	s.water = getTile(pos)->isWater();
+
+	std::queue<int3> toVisit;
+	toVisit.push(pos);
+	while(!toVisit.empty())
+	{
+		int3 curPos = toVisit.front();
+		toVisit.pop();
+		TSectorID &sec = retreiveTile(curPos);
+		if(sec == NOT_CHECKED)
+		{
+			const TerrainTile *t = getTile(curPos);
+			if(!markIfBlocked(sec, curPos, t))
+			{
+				if(t->isWater() == s.water) //sector is only-water or only-land
+				{
+					sec = num;
+					s.tiles.push_back(curPos);
+					for(auto & dir : int3::getDirs())
+					{
+						const int3 neighPos = curPos + dir;
+						if(!cbp->isInTheMap(neighPos))
+							continue;
+
+						const TSectorID neighSec = retreiveTile(neighPos);
+						if(neighSec == NOT_CHECKED)
+						{
+							toVisit.push(neighPos);
+						}
+						else if(neighSec >= FIRST_SECTOR && neighSec != num && infoOnSectors.at(neighSec).water == s.water)
+						{
+							adjacentSectors.insert(neighSec);
+						}
+						const TerrainTile *nt = getTile(neighPos);
+						if(nt && nt->isWater() != s.water && canBeEmbarkmentPoint(nt, s.water))
+						{
+							s.embarkmentPoints.push_back(neighPos);
+						}
+					}
+
+					if(t->visitable)
+						addVisitableObj(s, curPos, t);
+				}
+			}
+		}
+	}
+
+	vstd::removeDuplicates(s.embarkmentPoints);
+}
+
+int SectorMap::mergeSectors(int first, int second)
+{
+	//smaller sector is joined into bigger one, so each tile is relabelled at most log(n) times
+	if(infoOnSectors.at(first).tiles.size() < infoOnSectors.at(second).tiles.size())
+		std::swap(first, second);
+
+	Sector & target = infoOnSectors.at(first);
+	Sector & source = infoOnSectors.at(second);
+	for(auto & tile : source.tiles)
+		retreiveTile(tile) = first;
+
+	range::copy(source.tiles, std::back_inserter(target.tiles));
+	range::copy(source.visitableObjs, std::back_inserter(target.visitableObjs));
+	range::copy(source.embarkmentPoints, std::back_inserter(target.embarkmentPoints));
+	vstd::removeDuplicates(target.embarkmentPoints);
+	target.generation = nextGeneration++;
+
+	releaseSector(second);
+	return first;
+}
+
+int SectorMap::newSectorId()
+{
+	if(!freeSectorIds.empty())
+	{
+		int id = freeSectorIds.back();
+		freeSectorIds.pop_back();
+		return id;
+	}
+	assert(nextSectorId < std::numeric_limits<TSectorID>::max());
+	return nextSectorId++;
+}
+
+void SectorMap::releaseSector(int id)
+{
+	infoOnSectors.erase(id);
+	freeSectorIds.push_back(id);
+}
+
+void SectorMap::addVisitableObj(Sector & s, crint3 pos, const TerrainTile * t)
+{
+	auto obj = t->visitableObjects.front();
+	if(cbp->getObj(obj->id, false)) // FIXME: we have to filter invisible objcts like events, but probably TerrainTile shouldn't be used in SectorMap at all
+	{
+		s.visitableObjs.push_back(obj);
+		tileObjects[tileIndex(pos)] = obj;
+	}
+}
+
+void SectorMap::updateEmbarkmentPoint(crint3 pos)
+{
+	const TerrainTile * t = getTile(pos);
+	for(auto & dir : int3::getDirs())
+	{
+		const int3 neighPos = pos + dir;
+		if(!cbp->isInTheMap(neighPos))
+			continue;
+
+		const TSectorID neighSec = retreiveTile(neighPos);
+		if(neighSec < FIRST_SECTOR)
+			continue;
+
+		Sector & s = infoOnSectors.at(neighSec);
+		vstd::erase_if_present(s.embarkmentPoints, pos);
+		if(t && t->isWater() != s.water && canBeEmbarkmentPoint(t, s.water))
+			s.embarkmentPoints.push_back(pos);
+	}
+}
+
+size_t SectorMap::tileIndex(crint3 pos) const
+{
+	return (pos.z * sizes.y + pos.y) * sizes.x + pos.x;
+}
+
+void SectorMap::write(crstring fname)
+{
+	std::ofstream out(fname);
+	for(int k = 0; k < sizes.z; k++)
+	{
+		for(int j = 0; j < sizes.y; j++)
+		{
+			for(int i = 0; i < sizes.x; i++)
+			{
+				out << (int)sector[i][j][k] << '\t';
+			}
+			out << std::endl;
+		}
+		out << std::endl;
+	}
+}
+
+SectorMap::TSectorID & SectorMap::retreiveTile(crint3 pos)
+{
+	return retreiveTileN(sector, pos);
+}
+
+TerrainTile* SectorMap::getTile(crint3 pos) const
+{
+	//out of bounds access should be handled by boost::multi_array
+	//still we cached this array to avoid any checks
+	return visibleTiles->operator[](pos.x)[pos.y][pos.z];
+}
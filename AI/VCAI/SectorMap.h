@@ -0,0 +1,106 @@
+/*
+ * SectorMap.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "AIUtility.h"
+
+class CPlayerSpecificInfoCallback;
+
+enum {NOT_VISIBLE = 0, NOT_CHECKED = 1, NOT_AVAILABLE};
+
+bool canBeEmbarkmentPoint(const TerrainTile *t, bool fromWater);
+
+/// Sectors of whole map as seen by AI player, shared by all its heroes
+/// Map is explored once, later only tiles reported by invalidate() are checked again on update():
+/// new sectors are flood filled and merged with adjacent ones, only sectors which lost a tile are explored again
+struct SectorMap
+{
+	//a sector is set of tiles that would be mutually reachable if all visitable objs would be passable (incl monsters)
+	struct Sector
+	{
+		int id;
+		ui32 generation; //changes whenever tiles or objects of sector change
+		std::vector<int3> tiles;
+		std::vector<int3> embarkmentPoints; //tiles of other sectors onto which we can (dis)embark
+		std::vector<const CGObjectInstance *> visitableObjs;
+		bool water; //all tiles of sector are land or water
+		Sector()
+		{
+			id = -1;
+			generation = 0;
+			water = false;
+		}
+	};
+
+	/// Paths inside sector of hero, computed again only when hero moves or its sector changes
+	struct HeroParents
+	{
+		int3 source;
+		int sectorId;
+		ui32 generation;
+		std::vector<int3> parent; //indexed by tileIndex(), invalid int3 if tile has no parent
+	};
+
+	typedef unsigned short TSectorID; //smaller than int to allow -1 value. Max number of sectors 65K should be enough for any proper map.
+	typedef boost::multi_array<TSectorID, 3> TSectorArray;
+
+	CPlayerSpecificInfoCallback * cbp;
+	bool valid; //some kind of lazy eval
+	int3 sizes;
+	TSectorArray sector;
+
+	std::map<int, Sector> infoOnSectors;
+	std::shared_ptr<boost::multi_array<TerrainTile*, 3>> visibleTiles;
+	std::vector<const CGObjectInstance *> tileObjects; //indexed by tileIndex(), object added to sector for tile
+
+	std::unordered_set<int3, ShashInt3> changedTiles; //to be checked on next update
+	std::vector<int> freeSectorIds;
+	int nextSectorId;
+	ui32 nextGeneration;
+	std::map<const CGHeroInstance *, HeroParents> heroParents;
+
+	SectorMap(CPlayerSpecificInfoCallback * cbp);
+	void update();
+	void clear();
+	void write(crstring fname);
+
+	/// Whole map will be explored again on next update
+	void invalidate();
+	void invalidate(crint3 pos);
+	/// Should be called before object is removed from map
+	void invalidate(const CGObjectInstance * obj);
+	void forgetHero(const CGHeroInstance * h);
+
+	void rebuild();
+	void applyChanges();
+	void exploreNewSector(crint3 pos, int num, std::set<int> & adjacentSectors);
+	int mergeSectors(int first, int second);
+	int newSectorId();
+	void releaseSector(int id);
+	void addVisitableObj(Sector & s, crint3 pos, const TerrainTile * t);
+	void updateEmbarkmentPoint(crint3 pos);
+
+	size_t tileIndex(crint3 pos) const;
+	bool markIfBlocked(TSectorID &sec, crint3 pos, const TerrainTile *t);
+	bool markIfBlocked(TSectorID &sec, crint3 pos);
+	TSectorID & retreiveTile(crint3 pos);
+	TSectorID & retreiveTileN(TSectorArray &vectors, const int3 &pos);
+	const TSectorID & retreiveTileN(const TSectorArray &vectors, const int3 &pos);
+	TerrainTile* getTile(crint3 pos) const;
+
+	//queries below depend on AI state and are implemented in VCAI.cpp
+	std::vector<const CGObjectInstance *> getNearbyObjs(HeroPtr h, bool sectorsAround);
+
+	void makeParentBFS(std::vector<int3> & parent, crint3 source);
+	const std::vector<int3> & getParents(HeroPtr h);
+
+	int3 firstTileToGet(HeroPtr h, crint3 dst); //if h wants to reach tile dst, which tile he should visit to clear the way?
+	int3 findFirstVisitableTile(HeroPtr h, crint3 dst);
+};
@@ -108,10 +108,13 @@ void VCAI::heroMoved(const TryMoveHero & details)
 
 	validateObject(details.id); //enemy hero may have left visible area
 	auto hero = cb->getHero(details.id);
-	cachedSectorMaps.clear();
 
 	const int3 from = CGHeroInstance::convertPosition(details.start, false),
 		to = CGHeroInstance::convertPosition(details.end, false);
+	sectorMap->invalidate(from);
+	sectorMap->invalidate(to);
+	dangerMap.invalidate(from);
+	dangerMap.invalidate(to);
 	const CGObjectInstance *o1 = vstd::frontOrNull(cb->getVisitableObjs(from)),
 		*o2 = vstd::frontOrNull(cb->getVisitableObjs(to));
 
@@ -296,6 +299,12 @@ void VCAI::tileHidden(const std::unordered_set<int3, ShashInt3> &pos)
 
 	validateVisitableObjs();
 	clearPathsInfo();
+	for(int3 tile : pos)
+	{
+		sectorMap->invalidate(tile);
+		dangerMap.invalidate(tile);
+	}
+	explorationFrontier.update(pos);
 }
 
 void VCAI::tileRevealed(const std::unordered_set<int3, ShashInt3> &pos)
@@ -303,8 +312,13 @@ void VCAI::tileRevealed(const std::unordered_set<int3, ShashInt3> &pos)
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
 	for(int3 tile : pos)
+	{
 		for(const CGObjectInstance *obj : myCb->getVisitableObjs(tile))
 			addVisitableObj(obj);
+		sectorMap->invalidate(tile);
+		dangerMap.invalidate(tile);
+	}
+	explorationFrontier.update(pos);
 
 	clearPathsInfo();
 }
@@ -396,7 +410,8 @@ void VCAI::newObject(const CGObjectInstance * obj)
 	if(obj->isVisitable())
 		addVisitableObj(obj);
 
-	cachedSectorMaps.clear();
+	sectorMap->invalidate(obj);
+	dangerMap.invalidate(obj);
 }
 
 void VCAI::objectRemoved(const CGObjectInstance *obj)
@@ -413,6 +428,8 @@ void VCAI::objectRemoved(const CGObjectInstance *obj)
 	//TODO: Find better way to handle hero boat removal
 	if(auto hero = dynamic_cast<const CGHeroInstance *>(obj))
 	{
+		dangerMap.forgetHero(hero);
+		sectorMap->forgetHero(hero);
 		if(hero->boat)
 		{
 			vstd::erase_if_present(visitableObjs, hero->boat);
@@ -423,7 +440,8 @@ void VCAI::objectRemoved(const CGObjectInstance *obj)
 		}
 	}
 
-	cachedSectorMaps.clear(); //invalidate all paths
+	sectorMap->invalidate(obj); //objectRemoved is called before obj is removed from map
+	dangerMap.invalidate(obj);
 
 	//TODO
 	//there are other places where CGObjectinstance ptrs are stored...
@@ -549,6 +567,8 @@ void VCAI::objectPropertyChanged(const SetObjectProperty * sop)
 				vstd::erase_if_present(alreadyVisited, obj);
 			}
 		}
+		if(auto obj = myCb->getObj(sop->id, false))
+			dangerMap.invalidate(obj);
 	}
 }
 
@@ -591,6 +611,8 @@ void VCAI::init(std::shared_ptr<CCallback> CB)
 		fh = new FuzzyHelper();
 
 	retreiveVisitableObjs();
+	explorationFrontier.reset();
+	sectorMap = std::make_shared<SectorMap>(myCb.get());
 }
 
 void VCAI::yourTurn()
@@ -755,6 +777,8 @@ void VCAI::makeTurn()
 	MAKING_TURN;
 	boost::shared_lock<boost::shared_mutex> gsLock(CGameState::mutex);
 	setThreadName("VCAI::makeTurn");
+	dangerMap.reset();
+	sectorMap->invalidate(); //not every change of map is reported, explore it again once per turn
 
 	switch(cb->getDate(Date::DAY_OF_WEEK))
 	{
@@ -826,6 +850,7 @@ void VCAI::makeTurnInternal()
 		{
 			oldMovement = newMovement; //remember old value
 			newMovement = 0;
+			myCb->preparePaths(cb->getHeroesInfo()); //priorities of missions are evaluated using paths of all our heroes
 			std::vector<std::pair<HeroPtr, Goals::TSubgoal> > safeCopy;
 			for (auto mission : lockedHeroes)
 			{
@@ -1699,6 +1724,7 @@ void VCAI::battleEnd(const BattleResult *br)
 	bool won = br->winner == myCb->battleGetMySide();
 	logAi->debug("Player %d (%s): I %s the %s!", playerID, playerID.getStr(), (won  ? "won" : "lost"), battlename);
 	battlename.clear();
+	dangerMap.reset(); //armies of both sides have changed
 	CAdventureAI::battleEnd(br);
 }
 
@@ -1747,7 +1773,6 @@ bool VCAI::isAbleToExplore (HeroPtr h)
 void VCAI::clearPathsInfo()
 {
 	heroesUnableToExplore.clear();
-	cachedSectorMaps.clear();
 }
 
 void VCAI::validateVisitableObjs()
@@ -2621,35 +2646,33 @@ int3 VCAI::explorationNewPoint(HeroPtr h)
 	int radius = h->getSightRadius();
 	CCallback * cbp = cb.get();
 	const CGHeroInstance * hero = h.get();
+	const CPathsInfo * pathsInfo = cbp->getPathsInfo(hero);
 
-	std::vector<std::vector<int3> > tiles; //tiles[distance_to_fow]
-	tiles.resize(radius);
-
-	foreach_tile_pos([&](const int3 &pos)
-	{
-		if(!cbp->isVisible(pos))
-			tiles[0].push_back(pos);
-	});
+	std::vector<std::vector<int3> > tiles; //tiles[distance_to_fow - 1]
+	explorationFrontier.getTilesNearFog(radius, tiles);
 
 	float bestValue = 0; //discovered tile to node distance ratio
 	int3 bestTile(-1,-1,-1);
 	int3 ourPos = h->convertPosition(h->pos, false);
+	const int maxDiscovered = (2 * radius + 1) * (2 * radius + 1);
 
-	for (int i = 1; i < radius; i++)
+	for (auto & ring : tiles)
 	{
-		getVisibleNeighbours(tiles[i-1], tiles[i]);
-		vstd::removeDuplicates(tiles[i]);
-
-		for(const int3 &tile : tiles[i])
+		for(const int3 &tile : ring)
 		{
 			if (tile == ourPos) //shouldn't happen, but it does
 				continue;
-			if (!cb->getPathsInfo(hero)->getPathInfo(tile)->reachable()) //this will remove tiles that are guarded by monsters (or removable objects)
+			const CGPathNode * node = pathsInfo->getPathInfo(tile);
+			if (!node->reachable()) //this will remove tiles that are guarded by monsters (or removable objects)
 				continue;
 
-			CGPath path;
-			cb->getPathsInfo(hero)->getPath(path, tile);
-			float ourValue = (float)howManyTilesWillBeDiscovered(tile, radius, cbp) / (path.nodes.size() + 1); //+1 prevents erratic jumps
+			// path length in tiles, estimated from movement points spent on the way
+			const int movementCost = (int)hero->movement + node->turns * hero->maxMovePoints(node->layer != EPathfindingLayer::SAIL) - (int)node->moveRemains;
+			const float distance = (float)std::max(movementCost, 0) / GameConstants::BASE_MOVEMENT_COST + 1; //path also includes starting tile
+			if ((float)maxDiscovered / (distance + 1) <= bestValue) //even fully hidden surroundings wouldn't beat best tile
+				continue;
+
+			float ourValue = (float)howManyTilesWillBeDiscovered(tile, radius, cbp) / (distance + 1); //+1 prevents erratic jumps
 
 			if (ourValue > bestValue) //avoid costly checks of tiles that don't reveal much
 			{
@@ -2671,26 +2694,17 @@ int3 VCAI::explorationDesperate(HeroPtr h)
 	auto sm = getCachedSectorMap(h);
 	int radius = h->getSightRadius();
 
-	std::vector<std::vector<int3> > tiles; //tiles[distance_to_fow]
-	tiles.resize(radius);
+	std::vector<std::vector<int3> > tiles; //tiles[distance_to_fow - 1]
+	explorationFrontier.getTilesNearFog(radius, tiles);
 
 	CCallback * cbp = cb.get();
 
-	foreach_tile_pos([&](const int3 &pos)
-	{
-		if(!cbp->isVisible(pos))
-			tiles[0].push_back(pos);
-	});
-
 	ui64 lowestDanger = -1;
 	int3 bestTile(-1,-1,-1);
 
-	for(int i = 1; i < radius; i++)
+	for(auto & ring : tiles)
 	{
-		getVisibleNeighbours(tiles[i-1], tiles[i]);
-		vstd::removeDuplicates(tiles[i]);
-
-		for(const int3 &tile : tiles[i])
+		for(const int3 &tile : ring)
 		{
 			if (cbp->getTile(tile)->blocked) //does it shorten the time?
 				continue;
@@ -2823,7 +2837,7 @@ void VCAI::lostHero(HeroPtr h)
 		vstd::erase_if_present(reservedObjs, obj); //unreserve all objects for that hero
 	}
 	vstd::erase_if_present(reservedHeroesMap, h);
-	vstd::erase_if_present(cachedSectorMaps, h);
+	sectorMap->forgetHero(h.h);
 }
 
 void VCAI::answerQuery(QueryID queryID, int selection)
@@ -2892,14 +2906,8 @@ TResources VCAI::freeResources() const
 
 std::shared_ptr<SectorMap> VCAI::getCachedSectorMap(HeroPtr h)
 {
-	auto it = cachedSectorMaps.find(h);
-	if (it != cachedSectorMaps.end())
-		return it->second;
-	else
-	{
-		cachedSectorMaps[h] = std::make_shared<SectorMap>(h);
-		return cachedSectorMaps[h];
-	}
+	sectorMap->update();
+	return sectorMap;
 }
 
 AIStatus::AIStatus()
@@ -3055,150 +3063,6 @@ bool AIStatus::channelProbing()
 	return ongoingChannelProbing;
 }
 
-SectorMap::SectorMap()
-{
-	update();
-}
-
-SectorMap::SectorMap(HeroPtr h)
-{
-	update();
-	makeParentBFS(h->visitablePos());
-}
-
-bool SectorMap::markIfBlocked(TSectorID &sec, crint3 pos, const TerrainTile *t)
-{
-	if(t->blocked && !t->visitable)
-	{
-		sec = NOT_AVAILABLE;
-		return true;
-	}
-
-	return false;
-}
-
-bool SectorMap::markIfBlocked(TSectorID &sec, crint3 pos)
-{
-	return markIfBlocked(sec, pos, getTile(pos));
-}
-
-void SectorMap::update()
-{
-	visibleTiles = cb->getAllVisibleTiles();
-	auto shape = visibleTiles->shape();
-	sector.resize(boost::extents[shape[0]][shape[1]][shape[2]]);
-
-	clear();
-	int curSector = 3; //0 is invisible, 1 is not explored
-
-	CCallback * cbp = cb.get(); //optimization
-	foreach_tile_pos([&](crint3 pos)
-	{
-		if(retreiveTile(pos) == NOT_CHECKED)
-		{
-			if(!markIfBlocked(retreiveTile(pos), pos))
-				exploreNewSector(pos, curSector++, cbp);
-		}
-	});
-	valid = true;
-}
-
-SectorMap::TSectorID &SectorMap::retreiveTileN(SectorMap::TSectorArray &a, const int3 &pos)
-{
-	return a[pos.x][pos.y][pos.z];
-}
-
-const SectorMap::TSectorID &SectorMap::retreiveTileN(const SectorMap::TSectorArray &a, const int3 &pos)
-{
-	return a[pos.x][pos.y][pos.z];
-}
-
-void SectorMap::clear()
-{
-	//TODO: rotate to [z][x][y]
-	auto fow = cb->getVisibilityMap();
-	//TODO: any magic to automate this? will need array->array conversion
-	//std::transform(fow.begin(), fow.end(), sector.begin(), [](const ui8 &f) -> unsigned short
-	//{
-	//	return f; //type conversion
-	//});
-	auto width = fow.size();
-	auto height = fow.front().size();
-	auto depth = fow.front().front().size();
-	for (size_t x = 0; x < width; x++)
-		for (size_t y = 0; y < height; y++ )
-			for (size_t z = 0; z < depth; z++)
-				sector[x][y][z] = fow[x][y][z];
-	valid = false;
-}
-
-void SectorMap::exploreNewSector(crint3 pos, int num, CCallback * cbp)
-{
-	Sector &s = infoOnSectors[num];
-	s.id = num;
-	s.water = getTile(pos)->isWater();
-
-	std::queue<int3> toVisit;
-	toVisit.push(pos);
-	while(!toVisit.empty())
-	{
-		int3 curPos = toVisit.front();
-		toVisit.pop();
-		TSectorID &sec = retreiveTile(curPos);
-		if(sec == NOT_CHECKED)
-		{
-			const TerrainTile *t = getTile(curPos);
-			if(!markIfBlocked(sec, curPos, t))
-			{
-				if(t->isWater() == s.water) //sector is only-water or only-land
-				{
-					sec = num;
-					s.tiles.push_back(curPos);
-					foreach_neighbour(cbp, curPos, [&](CCallback * cbp, crint3 neighPos)
-					{
-						if(retreiveTile(neighPos) == NOT_CHECKED)
-						{
-							toVisit.push(neighPos);
-							//parent[neighPos] = curPos;
-						}
-						const TerrainTile *nt = getTile(neighPos);
-						if(nt && nt->isWater() != s.water && canBeEmbarkmentPoint(nt, s.water))
-						{
-							s.embarkmentPoints.push_back(neighPos);
-						}
-					});
-
-					if(t->visitable)
-					{
-						auto obj = t->visitableObjects.front();
-						if(cb->getObj(obj->id, false)) // FIXME: we have to filter invisible objcts like events, but probably TerrainTile shouldn't be used in SectorMap at all
-							s.visitableObjs.push_back(obj);
-					}
-				}
-			}
-		}
-	}
-
-	vstd::removeDuplicates(s.embarkmentPoints);
-}
-
-void SectorMap::write(crstring fname)
-{
-	std::ofstream out(fname);
-	for(int k = 0; k < cb->getMapSize().z; k++)
-	{
-		for(int j = 0; j < cb->getMapSize().y; j++)
-		{
-			for(int i = 0; i < cb->getMapSize().x; i++)
-			{
-				out << (int)sector[i][j][k] << '\t';
-			}
-			out << std::endl;
-		}
-		out << std::endl;
-	}
-}
-
 bool isWeeklyRevisitable (const CGObjectInstance * obj)
 { //TODO: allow polling of remaining creatures in dwelling
 	if (dynamic_cast<const CGVisitableOPW *>(obj) || //ensures future compatibility, unlike IDs
@@ -3494,6 +3358,7 @@ int3 SectorMap::findFirstVisitableTile (HeroPtr h, crint3 dst)
 {
 	int3 ret(-1,-1,-1);
 	int3 curtile = dst;
+	const auto & parent = getParents(h);
 
 	while(curtile != h->visitablePos())
 	{
@@ -3510,11 +3375,11 @@ int3 SectorMap::findFirstVisitableTile (HeroPtr h, crint3 dst)
 		}
 		else
 		{
-			auto i = parent.find(curtile);
-			if(i != parent.end())
+			const int3 & previous = parent[tileIndex(curtile)];
+			if(previous.valid())
 			{
-				assert(curtile != i->second);
-				curtile = i->second;
+				assert(curtile != previous);
+				curtile = previous;
 			}
 			else
 			{
@@ -3526,9 +3391,28 @@ int3 SectorMap::findFirstVisitableTile (HeroPtr h, crint3 dst)
 	return ret;
 }
 
-void SectorMap::makeParentBFS(crint3 source)
+const std::vector<int3> & SectorMap::getParents(HeroPtr h)
+{
+	const int3 source = h->visitablePos();
+	const int sectorId = retreiveTile(source);
+	auto sectorInfo = infoOnSectors.find(sectorId);
+	const ui32 generation = sectorInfo != infoOnSectors.end() ? sectorInfo->second.generation : 0;
+
+	HeroParents & parents = heroParents[h.h];
+	if(parents.parent.empty() || parents.source != source || parents.sectorId != sectorId || parents.generation != generation)
+	{
+		parents.source = source;
+		parents.sectorId = sectorId;
+		parents.generation = generation;
+		makeParentBFS(parents.parent, source);
+	}
+	return parents.parent;
+}
+
+void SectorMap::makeParentBFS(std::vector<int3> & parent, crint3 source)
 {
-	parent.clear();
+	parent.assign(sizes.x * sizes.y * sizes.z, int3(-1, -1, -1));
+	parent[tileIndex(source)] = source; //visited, path ends here
 
 	int mySector = retreiveTile(source);
 	std::queue<int3> toVisit;
@@ -3543,30 +3427,18 @@ void SectorMap::makeParentBFS(crint3 source)
 
 		foreach_neighbour(curPos, [&](crint3 neighPos)
 		{
-			if(retreiveTile(neighPos) == mySector && !vstd::contains(parent, neighPos))
+			if(retreiveTile(neighPos) == mySector && !parent[tileIndex(neighPos)].valid())
 			{
 				if (cb->canMoveBetween(curPos, neighPos))
 				{
 					toVisit.push(neighPos);
-					parent[neighPos] = curPos;
+					parent[tileIndex(neighPos)] = curPos;
 				}
 			}
 		});
 	}
 }
 
-SectorMap::TSectorID & SectorMap::retreiveTile(crint3 pos)
-{
-	return retreiveTileN(sector, pos);
-}
-
-TerrainTile* SectorMap::getTile(crint3 pos) const
-{
-	//out of bounds access should be handled by boost::multi_array
-	//still we cached this array to avoid any checks
-	return visibleTiles->operator[](pos.x)[pos.y][pos.z];
-}
-
 std::vector<const CGObjectInstance *> SectorMap::getNearbyObjs(HeroPtr h, bool sectorsAround)
 {
 	const Sector *heroSector = &infoOnSectors[retreiveTile(h->visitablePos())];
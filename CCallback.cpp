@@ -302,12 +302,17 @@ const CPathsInfo * CCallback::getPathsInfo(const CGHeroInstance *h)
 	return cl->getPathsInfo(h);
 }
 
+void CCallback::preparePaths(const std::vector<const CGHeroInstance *> & heroes)
+{
+	cl->preparePaths(heroes);
+}
+
 int3 CCallback::getGuardingCreaturePosition(int3 tile)
 {
 	if (!gs->map->isInTheMap(tile))
 		return int3(-1,-1,-1);
 
-	return gs->map->guardingCreaturePositions[tile.x][tile.y][tile.z];
+	return gs->map->guardingCreaturePositions[gs->map->getTileIndex(tile)];
 }
 
 void CCallback::calculatePaths( const CGHeroInstance *hero, CPathsInfo &out)
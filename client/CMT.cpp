@@ -1181,6 +1181,8 @@ static bool recreateWindow(int w, int h, int bpp, bool fullscreen, int displayIn
 	SDL_RenderClear(mainRenderer);
 	SDL_RenderPresent(mainRenderer);
 
+	GH.invalidateScreen();
+
 	return true;
 }
 
@@ -1297,6 +1299,9 @@ static void handleEvent(SDL_Event & ev)
 		case SDL_WINDOWEVENT_RESTORED:
 			fullScreenChanged();
 			break;
+		case SDL_WINDOWEVENT_EXPOSED:
+			GH.invalidateScreen();
+			break;
 		}
 		return;
 	}
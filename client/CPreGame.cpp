@@ -1117,75 +1117,72 @@ void SelectionTab::parseMaps(const std::unordered_set<ResourceID> &files)
 {
 	logGlobal->debug("Parsing %d maps", files.size());
 	allItems.clear();
-	for(auto & file : files)
+
+	CMapInfoIndex index(VCMIDirs::get().userCachePath() / "mapIndex.dat");
+	auto infos = index.getInfos(files, [](const ResourceID & file, CMapInfo & mapInfo)
 	{
-		try
-		{
-			CMapInfo mapInfo;
-			mapInfo.mapInit(file.getName());
+		mapInfo.mapInit(file.getName());
+	});
 
-			// ignore unsupported map versions (e.g. WoG maps without WoG)
-			// but accept VCMI maps
-			if((mapInfo.mapHeader->version >= EMapFormat::VCMI) || (mapInfo.mapHeader->version <= CGI->modh->settings.data["textData"]["mapVersion"].Float()))
-				allItems.push_back(std::move(mapInfo));
-		}
-		catch(std::exception & e)
-		{
-			logGlobal->error("Map %s is invalid. Message: %s", file.getName(), e.what());
-		}
+	for(auto & mapInfo : infos)
+	{
+		// ignore unsupported map versions (e.g. WoG maps without WoG)
+		// but accept VCMI maps
+		if((mapInfo.mapHeader->version >= EMapFormat::VCMI) || (mapInfo.mapHeader->version <= CGI->modh->settings.data["textData"]["mapVersion"].Float()))
+			allItems.push_back(std::move(mapInfo));
 	}
 }
 
 void SelectionTab::parseGames(const std::unordered_set<ResourceID> &files, CMenuScreen::EGameMode gameMode)
 {
-	for(auto & file : files)
-	{
-		try
-		{
-			CLoadFile lf(*CResourceHandler::get()->getResourceName(file), MINIMAL_SERIALIZATION_VERSION);
-			lf.checkMagicBytes(SAVEGAME_MAGIC);
-// 			ui8 sign[8];
-// 			lf >> sign;
-// 			if(std::memcmp(sign,"VCMISVG",7))
-// 			{
-// 				throw std::runtime_error("not a correct savefile!");
-// 			}
-
-			// Create the map info object
-			CMapInfo mapInfo;
-			mapInfo.mapHeader = make_unique<CMapHeader>();
-			mapInfo.scenarioOpts = nullptr;//to be created by serialiser
-			lf >> *(mapInfo.mapHeader.get()) >> mapInfo.scenarioOpts;
-			mapInfo.fileURI = file.getName();
-			mapInfo.countPlayers();
-			std::time_t time = boost::filesystem::last_write_time(*CResourceHandler::get()->getResourceName(file));
-			mapInfo.date = std::asctime(std::localtime(&time));
-
-			// Filter out other game modes
-			bool isCampaign = mapInfo.scenarioOpts->mode == StartInfo::CAMPAIGN;
-			bool isMultiplayer = mapInfo.actualHumanPlayers > 1;
-			switch(gameMode)
-			{
-			case CMenuScreen::SINGLE_PLAYER:
-				if(isMultiplayer || isCampaign)
-					mapInfo.mapHeader.reset();
-				break;
-			case CMenuScreen::SINGLE_CAMPAIGN:
-				if(!isCampaign)
-					mapInfo.mapHeader.reset();
-				break;
-			default:
-				if(!isMultiplayer)
-					mapInfo.mapHeader.reset();
-				break;
-			}
+	CMapInfoIndex index(VCMIDirs::get().userCachePath() / "saveIndex.dat");
+	auto infos = index.getInfos(files, [](const ResourceID & file, CMapInfo & mapInfo)
+	{
+		CLoadFile lf(*CResourceHandler::get()->getResourceName(file), MINIMAL_SERIALIZATION_VERSION);
+		lf.checkMagicBytes(SAVEGAME_MAGIC);
+// 		ui8 sign[8];
+// 		lf >> sign;
+// 		if(std::memcmp(sign,"VCMISVG",7))
+// 		{
+// 			throw std::runtime_error("not a correct savefile!");
+// 		}
+
+		// Fill the map info object
+		mapInfo.mapHeader = make_unique<CMapHeader>();
+		mapInfo.scenarioOpts = nullptr;//to be created by serialiser
+		lf >> *(mapInfo.mapHeader.get()) >> mapInfo.scenarioOpts;
+		mapInfo.fileURI = file.getName();
+		mapInfo.countPlayers();
+
+		// localtime and asctime use static buffer, while saves are parsed in parallel
+		static boost::mutex timeMutex;
+		boost::unique_lock<boost::mutex> lock(timeMutex);
+		std::time_t time = boost::filesystem::last_write_time(*CResourceHandler::get()->getResourceName(file));
+		mapInfo.date = std::asctime(std::localtime(&time));
+	});
 
-			allItems.push_back(std::move(mapInfo));
-		}
-		catch(const std::exception & e)
+	for(auto & mapInfo : infos)
+	{
+		// Filter out other game modes
+		bool isCampaign = mapInfo.scenarioOpts->mode == StartInfo::CAMPAIGN;
+		bool isMultiplayer = mapInfo.actualHumanPlayers > 1;
+		switch(gameMode)
 		{
-			logGlobal->error("Error: Failed to process %s: %s", file.getName(), e.what());
+		case CMenuScreen::SINGLE_PLAYER:
+			if(isMultiplayer || isCampaign)
+				mapInfo.mapHeader.reset();
+			break;
+		case CMenuScreen::SINGLE_CAMPAIGN:
+			if(!isCampaign)
+				mapInfo.mapHeader.reset();
+			break;
+		default:
+			if(!isMultiplayer)
+				mapInfo.mapHeader.reset();
+			break;
 		}
+
+		allItems.push_back(std::move(mapInfo));
 	}
 }
 
@@ -405,6 +405,9 @@ bool CVideoPlayer::playVideo(int x, int y, SDL_Surface *dst, bool stopOnKey)
 	pos.x = x;
 	pos.y = y;
 
+	// video is presented over screen texture, it has to be presented again afterwards
+	GH.invalidateScreen();
+
 	while(nextFrame())
 	{
 
@@ -119,7 +119,8 @@ void CClient::init()
 		TLockGuard _(connectionHandlerMutex);
 		connectionHandler.reset();
 	}
-	pathInfo = nullptr;
+	pathCache.clear();
+	pathCacheUses = 0;
 	applier = new CApplier<CBaseForCLApply>();
 	registerTypesClientPacks1(*applier);
 	registerTypesClientPacks2(*applier);
@@ -298,7 +299,7 @@ void CClient::loadGame(const std::string & fname, const bool server, const std::
 		logNetwork->info("Loaded common part of save %d ms", tmh.getDiff());
 		const_cast<CGameInfo*>(CGI)->mh = new CMapHandler();
 		const_cast<CGameInfo*>(CGI)->mh->map = gs->map;
-		pathInfo = make_unique<CPathsInfo>(getMapSize());
+		pathCache.clear();
 		CGI->mh->init();
 		logNetwork->info("Initing maphandler: %d ms", tmh.getDiff());
 	}
@@ -445,7 +446,7 @@ void CClient::newGame( CConnection *con, StartInfo *si )
 			logNetwork->info("Creating mapHandler: %d ms", tmh.getDiff());
 			CGI->mh->init();
 		}
-		pathInfo = make_unique<CPathsInfo>(getMapSize());
+		pathCache.clear();
 		logNetwork->info("Initializing mapHandler (together): %d ms", tmh.getDiff());
 	}
 
@@ -866,19 +867,100 @@ void CClient::commenceTacticPhaseForInt(std::shared_ptr<CBattleGameInterface> ba
 void CClient::invalidatePaths()
 {
 	// turn pathfinding info into invalid. It will be regenerated later
-	boost::unique_lock<boost::mutex> pathLock(pathInfo->pathMx);
-	pathInfo->hero = nullptr;
+	boost::unique_lock<boost::mutex> cacheLock(pathCacheMx);
+	for(auto & entry : pathCache)
+	{
+		boost::unique_lock<boost::mutex> pathLock(entry.paths->pathMx);
+		entry.paths->invalidate();
+	}
+}
+
+void CClient::invalidatePaths(const std::vector<int3> & changedTiles)
+{
+	// only parts of paths that depend on these tiles will be regenerated
+	boost::unique_lock<boost::mutex> cacheLock(pathCacheMx);
+	for(auto & entry : pathCache)
+	{
+		boost::unique_lock<boost::mutex> pathLock(entry.paths->pathMx);
+		entry.paths->invalidate(changedTiles);
+	}
+}
+
+void CClient::invalidatePaths(const CGObjectInstance * obj)
+{
+	boost::unique_lock<boost::mutex> cacheLock(pathCacheMx);
+	for(auto & entry : pathCache)
+	{
+		boost::unique_lock<boost::mutex> pathLock(entry.paths->pathMx);
+		entry.paths->invalidate(obj);
+	}
+}
+
+void CClient::invalidatePaths(const CGObjectInstance * obj, ui8 property)
+{
+	boost::unique_lock<boost::mutex> cacheLock(pathCacheMx);
+	for(auto & entry : pathCache)
+	{
+		boost::unique_lock<boost::mutex> pathLock(entry.paths->pathMx);
+		entry.paths->invalidate(obj, property);
+	}
+}
+
+CPathsInfo * CClient::getCachedPaths(const CGHeroInstance * h)
+{
+	auto entry = boost::find_if(pathCache, [&](const CachedPaths & cached){ return cached.hero == h; });
+	if(entry == pathCache.end())
+	{
+		if(pathCache.size() < PATH_CACHE_SIZE)
+		{
+			pathCache.push_back(CachedPaths());
+			pathCache.back().paths = make_unique<CPathsInfo>(getMapSize());
+			entry = pathCache.end() - 1;
+		}
+		else
+		{
+			entry = boost::min_element(pathCache, [](const CachedPaths & lhs, const CachedPaths & rhs){ return lhs.lastUse < rhs.lastUse; });
+		}
+		entry->hero = h;
+	}
+	entry->lastUse = ++pathCacheUses;
+	return entry->paths.get();
 }
 
 const CPathsInfo * CClient::getPathsInfo(const CGHeroInstance *h)
 {
 	assert(h);
-	boost::unique_lock<boost::mutex> pathLock(pathInfo->pathMx);
-	if (pathInfo->hero != h)
+	boost::unique_lock<boost::mutex> cacheLock(pathCacheMx);
+	CPathsInfo * paths = getCachedPaths(h);
+	boost::unique_lock<boost::mutex> pathLock(paths->pathMx);
+	if (paths->hero != h)
+	{
+		gs->updatePaths(h, *paths);
+	}
+	return paths;
+}
+
+void CClient::preparePaths(const std::vector<const CGHeroInstance *> & heroes)
+{
+	boost::unique_lock<boost::mutex> cacheLock(pathCacheMx);
+	std::vector<std::pair<const CGHeroInstance *, CPathsInfo *>> outdated;
+	std::vector<std::unique_ptr<boost::unique_lock<boost::mutex>>> pathLocks;
+	std::vector<const CGHeroInstance *> prepared;
+	for(auto h : heroes)
 	{
-		gs->calculatePaths(h, *pathInfo.get());
+		// more heroes than cache entries would overwrite paths calculated by this call
+		if(prepared.size() == PATH_CACHE_SIZE)
+			break;
+		if(vstd::contains(prepared, h))
+			continue;
+		prepared.push_back(h);
+
+		CPathsInfo * paths = getCachedPaths(h);
+		pathLocks.push_back(make_unique<boost::unique_lock<boost::mutex>>(paths->pathMx));
+		if(paths->hero != h)
+			outdated.push_back(std::make_pair(h, paths));
 	}
-	return pathInfo.get();
+	gs->updatePaths(outdated);
 }
 
 int CClient::sendRequest(const CPack *request, PlayerColor player)
@@ -122,7 +122,20 @@ public:
 /// Class which handles client - server logic
 class CClient : public IGameCallback
 {
-	std::unique_ptr<CPathsInfo> pathInfo;
+	/// Paths of recently used heroes. Least recently used entry is recalculated for hero that has none,
+	/// so pointers returned by getPathsInfo stay valid, as with single shared CPathsInfo
+	struct CachedPaths
+	{
+		const CGHeroInstance * hero; //hero this entry was last calculated for, paths->hero is reset on invalidation
+		ui32 lastUse;
+		std::unique_ptr<CPathsInfo> paths;
+	};
+	static const size_t PATH_CACHE_SIZE = 8;
+	std::vector<CachedPaths> pathCache;
+	ui32 pathCacheUses;
+	boost::mutex pathCacheMx;
+
+	CPathsInfo * getCachedPaths(const CGHeroInstance * h); //caller must hold pathCacheMx
 
 	std::map<PlayerColor, std::shared_ptr<boost::thread>> playerActionThreads;
 public:
@@ -170,7 +183,11 @@ public:
 	void proposeNextMission(std::shared_ptr<CCampaignState> camp);
 
 	void invalidatePaths();
+	void invalidatePaths(const std::vector<int3> & changedTiles);
+	void invalidatePaths(const CGObjectInstance * obj);
+	void invalidatePaths(const CGObjectInstance * obj, ui8 property);
 	const CPathsInfo * getPathsInfo(const CGHeroInstance *h);
+	void preparePaths(const std::vector<const CGHeroInstance *> & heroes); //calculates outdated paths of given heroes in parallel, so getPathsInfo of them won't block
 
 	bool terminate;	// tell to terminate
 	std::unique_ptr<boost::thread> connectionHandler; //thread running run() method
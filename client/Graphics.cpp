@@ -128,15 +128,13 @@ Graphics::Graphics()
 {
 	#if 0
 
-	std::vector<Task> tasks; //preparing list of graphics to load
-	tasks += std::bind(&Graphics::loadFonts,this);
-	tasks += std::bind(&Graphics::loadPaletteAndColors,this);
-	tasks += std::bind(&Graphics::initializeBattleGraphics,this);
-	tasks += std::bind(&Graphics::loadErmuToPicture,this);
-	tasks += std::bind(&Graphics::initializeImageLists,this);
-
-	CThreadHelper th(&tasks,std::max((ui32)1,boost::thread::hardware_concurrency()));
-	th.run();
+	CTaskGroup tasks("graphics"); //preparing list of graphics to load
+	tasks.run(std::bind(&Graphics::loadFonts,this));
+	tasks.run(std::bind(&Graphics::loadPaletteAndColors,this));
+	tasks.run(std::bind(&Graphics::initializeBattleGraphics,this));
+	tasks.run(std::bind(&Graphics::loadErmuToPicture,this));
+	tasks.run(std::bind(&Graphics::initializeImageLists,this));
+	tasks.wait();
 	#else
 	loadFonts();
 	loadPaletteAndColors();
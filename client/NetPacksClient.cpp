@@ -163,7 +163,7 @@ void SetMana::applyCl(CClient *cl)
 void SetMovePoints::applyCl(CClient *cl)
 {
 	const CGHeroInstance *h = cl->getHero(hid);
-	cl->invalidatePaths();
+	cl->invalidatePaths(h);
 	INTERFACE_CALL_IF_PRESENT(h->tempOwner, heroMovePointsChanged, h);
 }
 
@@ -183,7 +183,7 @@ void FoWChange::applyCl(CClient *cl)
 				i.second->tileHidden(tiles);
 		}
 	}
-	cl->invalidatePaths();
+	cl->invalidatePaths(std::vector<int3>(tiles.begin(), tiles.end()));
 }
 
 void SetAvailableHeroes::applyCl(CClient *cl)
@@ -266,6 +266,7 @@ void NewTurn::applyCl(CClient *cl)
 
 void GiveBonus::applyCl(CClient *cl)
 {
+	//affected tiles are not known, bonus may change passability anywhere
 	cl->invalidatePaths();
 	switch(who)
 	{
@@ -289,6 +290,8 @@ void ChangeObjPos::applyFirstCl(CClient *cl)
 	CGObjectInstance *obj = GS(cl)->getObjInstance(objid);
 	if(flags & 1 && CGI->mh)
 		CGI->mh->hideObject(obj);
+
+	cl->invalidatePaths(obj);
 }
 void ChangeObjPos::applyCl(CClient *cl)
 {
@@ -296,7 +299,7 @@ void ChangeObjPos::applyCl(CClient *cl)
 	if(flags & 1 && CGI->mh)
 		CGI->mh->printObject(obj);
 
-	cl->invalidatePaths();
+	cl->invalidatePaths(obj);
 }
 
 void PlayerEndsGame::applyCl(CClient *cl)
@@ -343,6 +346,12 @@ void RemoveObject::applyFirstCl(CClient *cl)
 {
 	const CGObjectInstance *o = cl->getObj(id);
 
+	//paths of removed hero can't be reused
+	if(o->ID == Obj::HERO)
+		cl->invalidatePaths();
+	else
+		cl->invalidatePaths(o);
+
 	if(CGI->mh)
 		CGI->mh->hideObject(o, true);
 
@@ -356,7 +365,6 @@ void RemoveObject::applyFirstCl(CClient *cl)
 
 void RemoveObject::applyCl(CClient *cl)
 {
-	cl->invalidatePaths();
 }
 
 void TryMoveHero::applyFirstCl(CClient *cl)
@@ -387,7 +395,11 @@ void TryMoveHero::applyFirstCl(CClient *cl)
 void TryMoveHero::applyCl(CClient *cl)
 {
 	const CGHeroInstance *h = cl->getHero(id);
-	cl->invalidatePaths();
+
+	//hero is visible on tile left of its h3m position
+	std::vector<int3> changedTiles = {start, end, start - int3(1, 0, 0), end - int3(1, 0, 0)};
+	vstd::concatenate(changedTiles, std::vector<int3>(fowRevealed.begin(), fowRevealed.end()));
+	cl->invalidatePaths(changedTiles);
 
 	if(CGI->mh)
 	{
@@ -534,6 +546,8 @@ void InfoWindow::applyCl(CClient *cl)
 
 void SetObjectProperty::applyCl(CClient *cl)
 {
+	cl->invalidatePaths(GS(cl)->getObjInstance(id), what);
+
 	//inform all players that see this object
 	for(auto it = cl->playerint.cbegin(); it != cl->playerint.cend(); ++it)
 	{
@@ -812,9 +826,10 @@ void SaveGame::applyCl(CClient *cl)
 
 	try
 	{
-		CSaveFile save(*CResourceHandler::get()->getResourceName(ResourceID(stem.to_string(), EResType::CLIENT_SAVEGAME)));
+		CSaveFile save(*CResourceHandler::get()->getResourceName(ResourceID(stem.to_string(), EResType::CLIENT_SAVEGAME)), CSaveFile::BACKGROUND);
 		cl->saveCommonState(save);
 		save << *cl;
+		save.finishInBackground();
 	}
 	catch(std::exception &e)
 	{
@@ -923,9 +938,9 @@ void CenterView::applyCl(CClient *cl)
 
 void NewObject::applyCl(CClient *cl)
 {
-	cl->invalidatePaths();
-
 	const CGObjectInstance *obj = cl->getObj(id);
+	cl->invalidatePaths(obj);
+
 	if(CGI->mh)
 		CGI->mh->printObject(obj, true);
 
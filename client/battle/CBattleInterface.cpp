@@ -157,6 +157,15 @@ CBattleInterface::CBattleInterface(const CCreatureSet *army1, const CCreatureSet
 	this->army1 = army1;
 	this->army2 = army2;
 	std::vector<const CStack*> stacks = curInt->cb->battleGetAllStacks(true);
+
+	//read creature animations of all stacks at once
+	std::vector<std::string> creatureAnimations;
+	for (const CStack *s : stacks)
+		creatureAnimations.push_back(s->getCreature()->animDefName);
+	if (siegeH)
+		creatureAnimations.push_back(CGI->creh->creatures[siegeH->town->town->clientInfo.siegeShooter]->animDefName);
+	CAnimation::prefetch(creatureAnimations);
+
 	for (const CStack *s : stacks)
 	{
 		newStack(s);
@@ -16,6 +16,7 @@
 #include "../Graphics.h"
 #include "../gui/SDL_Extensions.h"
 #include "../gui/SDL_Pixels.h"
+#include "../gui/CFileCache.h"
 
 #include "../lib/filesystem/Filesystem.h"
 #include "../lib/filesystem/ISimpleResourceLoader.h"
@@ -49,7 +50,7 @@ private:
 	//offset[group][frame] - offset of frame data in file
 	std::map<size_t, std::vector <size_t> > offset;
 
-	std::unique_ptr<ui8[]>       data;
+	std::shared_ptr<const ui8>   data; // shared with file cache, never modified
 	std::unique_ptr<SDL_Color[]> palette;
 
 public:
@@ -208,50 +209,6 @@ public:
 	~CompImageLoader();
 };
 
-// Extremely simple file cache. TODO: smarter, more general solution
-class CFileCache
-{
-	static const int cacheSize = 50; //Max number of cached files
-	struct FileData
-	{
-		ResourceID             name;
-		size_t                 size;
-		std::unique_ptr<ui8[]> data;
-
-		std::unique_ptr<ui8[]> getCopy()
-		{
-			auto ret = std::unique_ptr<ui8[]>(new ui8[size]);
-			std::copy(data.get(), data.get() + size, ret.get());
-			return ret;
-		}
-		FileData(ResourceID name_, size_t size_, std::unique_ptr<ui8[]> data_):
-			name{std::move(name_)},
-			size{size_},
-			data{std::move(data_)}
-		{}
-	};
-
-	std::deque<FileData> cache;
-public:
-	std::unique_ptr<ui8[]> getCachedFile(ResourceID rid)
-	{
-		for(auto & file : cache)
-		{
-			if (file.name == rid)
-				return file.getCopy();
-		}
-		// Still here? Cache miss
-		if (cache.size() > cacheSize)
-			cache.pop_front();
-
-		auto data =  CResourceHandler::get()->load(rid)->readAll();
-
-		cache.emplace_back(std::move(rid), data.second, std::move(data.first));
-
-		return cache.back().getCopy();
-	}
-};
-
 enum class DefType : uint32_t
 {
 	SPELL = 0x40,
@@ -266,7 +223,7 @@ enum class DefType : uint32_t
 	BATTLE_HERO = 0x49
 };
 
-static CFileCache animationCache;
+static CFileCache animationCache(32 * 1024 * 1024); //Max total size of cached def files, in bytes
 
 /*************************************************************************
  *  DefFile, class used for def loading                                  *
@@ -323,9 +280,9 @@ CDefFile::CDefFile(std::string Name):
 
 	for (ui32 i= 0; i<256; i++)
 	{
-		palette[i].r = data[it++];
-		palette[i].g = data[it++];
-		palette[i].b = data[it++];
+		palette[i].r = data.get()[it++];
+		palette[i].g = data.get()[it++];
+		palette[i].b = data.get()[it++];
 		palette[i].a = SDL_ALPHA_OPAQUE;
 	}
 
@@ -1624,6 +1581,18 @@ void CAnimation::preload()
 	}
 }
 
+void CAnimation::prefetch(const std::vector<std::string> & names)
+{
+	std::vector<ResourceID> resources;
+	for (const std::string & name : names)
+	{
+		ResourceID resource(std::string("SPRITES/") + name, EResType::ANIMATION);
+		if (CResourceHandler::get()->existsResource(resource) && !vstd::contains(resources, resource))
+			resources.push_back(resource);
+	}
+	animationCache.prefetch(resources);
+}
+
 void CAnimation::loadGroup(size_t group)
 {
 	if (vstd::contains(source, group))
@@ -119,6 +119,9 @@ public:
 	void unload();
 	void preload();
 
+	//loads def files of animations that are about to be created into cache, in parallel
+	static void prefetch(const std::vector<std::string> & names);
+
 	//all frames from group
 	void loadGroup  (size_t group);
 	void unloadGroup(size_t group);
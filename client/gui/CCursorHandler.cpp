@@ -83,11 +83,13 @@ void CCursorHandler::drawWithScreenRestore()
 	{
 		dndObject->moveTo(Point(x - dndObject->pos.w/2, y - dndObject->pos.h/2));
 		dndObject->showAll(screen);
+		GH.invalidate(dndObject->pos);
 	}
 	else
 	{
 		currentCursor->moveTo(Point(x,y));
 		currentCursor->showAll(screen);
+		GH.invalidate(currentCursor->pos);
 	}
 }
 
@@ -101,6 +103,9 @@ void CCursorHandler::drawRestored()
 
 	SDL_Rect temp_rect = genRect(40, 40, x, y);
 	SDL_BlitSurface(help, nullptr, screen, &temp_rect);
+
+	// texture still shows cursor at this place, it has to be sent again on next frame
+	GH.invalidate(dndObject ? dndObject->pos : currentCursor->pos);
 }
 
 void CCursorHandler::shiftPos( int &x, int &y )
@@ -219,13 +224,6 @@ void CCursorHandler::centerCursor()
 	SDL_EventState(SDL_MOUSEMOTION, SDL_ENABLE);
 }
 
-void CCursorHandler::render()
-{
-	drawWithScreenRestore();
-	CSDL_Ext::update(screen);
-	drawRestored();
-}
-
 CCursorHandler::CCursorHandler() = default;
 
 CCursorHandler::~CCursorHandler()
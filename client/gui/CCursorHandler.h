@@ -35,10 +35,6 @@ class CCursorHandler final
 
 	bool showing;
 
-	/// Draw cursor preserving original image below cursor
-	void drawWithScreenRestore();
-	/// Restore original image below cursor
-	void drawRestored();
 public:
 	/// position of cursor
 	int xpos, ypos;
@@ -61,7 +57,10 @@ public:
 	 */
 	void dragAndDropCursor (std::unique_ptr<CAnimImage> image);
 
-	void render();
+	/// Draw cursor preserving original image below cursor
+	void drawWithScreenRestore();
+	/// Restore original image below cursor
+	void drawRestored();
 
 	void shiftPos( int &x, int &y );
 	void hide() { showing=0; };
@@ -0,0 +1,99 @@
+/*
+ * CFileCache.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CFileCache.h"
+
+#include "../../lib/filesystem/Filesystem.h"
+#include "../../lib/CThreadHelper.h"
+
+CFileCache::CFileCache(size_t sizeLimit, TLoader loader):
+	sizeLimit(sizeLimit),
+	loader(loader ? loader : &CFileCache::loadResource),
+	totalSize(0)
+{
+}
+
+void CFileCache::insert(const ResourceID & rid, TFileData data, size_t size)
+{
+	if (vstd::contains(index, rid))
+		return; // loaded by another thread in the meantime
+
+	files.push_front(std::make_tuple(rid, data, size));
+	index[rid] = files.begin();
+	totalSize += size;
+
+	// most recent file is kept even if it alone exceeds limit
+	while (totalSize > sizeLimit && files.size() > 1)
+	{
+		totalSize -= std::get<2>(files.back());
+		index.erase(std::get<0>(files.back()));
+		files.pop_back();
+	}
+}
+
+std::pair<CFileCache::TFileData, size_t> CFileCache::loadResource(const ResourceID & rid)
+{
+	auto data = CResourceHandler::get()->load(rid)->readAll();
+	return std::make_pair(TFileData(data.first.release(), std::default_delete<ui8[]>()), static_cast<size_t>(data.second));
+}
+
+CFileCache::TFileData CFileCache::getCachedFile(const ResourceID & rid)
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		auto it = index.find(rid);
+		if (it != index.end())
+		{
+			files.splice(files.begin(), files, it->second);
+			return std::get<1>(*it->second);
+		}
+	}
+	// Still here? Cache miss, file is loaded without holding the lock
+	auto file = loader(rid);
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	insert(rid, file.first, file.second);
+	return file.first;
+}
+
+void CFileCache::prefetch(const std::vector<ResourceID> & resources)
+{
+	std::vector<ResourceID> toLoad;
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		for (const ResourceID & rid : resources)
+		{
+			if (vstd::contains(index, rid))
+				continue;
+
+			toLoad.push_back(rid);
+		}
+	}
+
+	CThreadPool::get().parallelFor("def prefetch", 0, toLoad.size(), [&](size_t i)
+	{
+		auto file = loader(toLoad[i]);
+
+		boost::unique_lock<boost::mutex> lock(mx);
+		insert(toLoad[i], file.first, file.second);
+	});
+}
+
+bool CFileCache::contains(const ResourceID & rid) const
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	return vstd::contains(index, rid);
+}
+
+size_t CFileCache::size() const
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	return totalSize;
+}
@@ -0,0 +1,46 @@
+/*
+ * CFileCache.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../../lib/filesystem/ResourceID.h"
+
+/// Recently loaded files, least recently used ones are dropped when total size exceeds limit
+/// Files are shared read-only, so returning cached file does not copy it. File dropped from cache
+/// stays valid for as long as anyone holds it
+class CFileCache
+{
+public:
+	typedef std::shared_ptr<const ui8> TFileData;
+	typedef std::function<std::pair<TFileData, size_t>(const ResourceID &)> TLoader;
+
+	/// Files are loaded from CResourceHandler unless other loader is given
+	CFileCache(size_t sizeLimit, TLoader loader = TLoader());
+
+	TFileData getCachedFile(const ResourceID & rid);
+	/// Loads all files which are not in cache yet, in parallel
+	void prefetch(const std::vector<ResourceID> & resources);
+
+	bool contains(const ResourceID & rid) const;
+	size_t size() const; //total size of cached files, in bytes
+
+private:
+	typedef std::list<std::tuple<ResourceID, TFileData, size_t>> TFileList; // most recently used first
+
+	const size_t sizeLimit;
+	const TLoader loader;
+
+	mutable boost::mutex mx;
+	TFileList files;
+	std::unordered_map<ResourceID, TFileList::iterator> index;
+	size_t totalSize;
+
+	void insert(const ResourceID & rid, TFileData data, size_t size); // must be called with locked mutex
+	static std::pair<TFileData, size_t> loadResource(const ResourceID & rid);
+};
@@ -171,6 +171,7 @@ void CGuiHandler::totalRedraw()
 	for(auto & elem : objsToBlit)
 		elem->showAll(screen2);
 	blitAt(screen2,0,0,screen);
+	invalidate(genRect(screen->h, screen->w, 0, 0));
 }
 
 void CGuiHandler::updateTime()
@@ -457,20 +458,66 @@ void CGuiHandler::renderFrame()
 		if(nullptr != curInt)
 			curInt->update();
 
+		// top interface is shown every frame
+		invalidateShownArea(topInt());
+		if(!objsToBlit.empty())
+			invalidateShownArea(objsToBlit.back());
+
 		if (settings["general"]["showfps"].Bool())
 			drawFPSCounter();
 
-		// draw the mouse cursor and update the screen
-		CCS->curh->render();
-
-		SDL_RenderCopy(mainRenderer, screenTexture, nullptr, nullptr);
+		// draw the mouse cursor and update changed parts of the screen
+		CCS->curh->drawWithScreenRestore();
+		const bool changed = updateScreenTexture();
+		CCS->curh->drawRestored();
 
-		SDL_RenderPresent(mainRenderer);
+		// same frame as before is not presented again, idle screens cost almost nothing
+		if(changed)
+		{
+			SDL_RenderCopy(mainRenderer, screenTexture, nullptr, nullptr);
+			SDL_RenderPresent(mainRenderer);
+		}
 	}
 
 	mainFPSmng->framerateDelay(); // holds a constant FPS
 }
 
+void CGuiHandler::invalidateScreen()
+{
+	screenDamage.invalidateAll();
+}
+
+void CGuiHandler::invalidate(const SDL_Rect & area)
+{
+	screenDamage.invalidate(area);
+}
+
+void CGuiHandler::invalidateShownArea(IShowable * object)
+{
+	auto widget = dynamic_cast<CIntObject *>(object);
+	if(!widget)
+	{
+		if(object)
+			invalidate(genRect(screen->h, screen->w, 0, 0));
+	}
+	else if(!(widget->type & IShowActivatable::REPORTS_CHANGES))
+	{
+		invalidate(widget->pos);
+	}
+}
+
+bool CGuiHandler::updateScreenTexture()
+{
+	const int bytesPerPixel = screen->format->BytesPerPixel;
+	const auto & rects = screenDamage.update(screen->pixels, screen->w, screen->h, screen->pitch, bytesPerPixel);
+	for(const SDL_Rect & rect : rects)
+	{
+		const ui8 * pixels = static_cast<const ui8 *>(screen->pixels) + rect.y * screen->pitch + rect.x * bytesPerPixel;
+		if(0 != SDL_UpdateTexture(screenTexture, &rect, pixels, screen->pitch))
+			logGlobal->error("%s SDL_UpdateTexture %s", __FUNCTION__, SDL_GetError());
+	}
+	return !rects.empty();
+}
 
 CGuiHandler::CGuiHandler()
 	: lastClick(-500, -500),lastClickTime(0), defActionsDef(0), captureChildren(false)
@@ -501,11 +548,18 @@ void CGuiHandler::breakEventHandling()
 void CGuiHandler::drawFPSCounter()
 {
 	const static SDL_Color yellow = {255, 255, 0, 0};
-	static SDL_Rect overlay = { 0, 0, 64, 32};
+	static SDL_Rect overlay = { 0, 0, 96, 48};
 	Uint32 black = SDL_MapRGB(screen->format, 10, 10, 10);
 	SDL_FillRect(screen, &overlay, black);
+	invalidate(overlay);
 	std::string fps = boost::lexical_cast<std::string>(mainFPSmng->fps);
 	graphics->fonts[FONT_BIG]->renderTextLeft(screen, fps, yellow, Point(10, 10));
+
+	// hit rate of rendered text caches since start of the game
+	TextCacheStats stats = IFont::getCacheStats();
+	ui64 hitRate = stats.hits * 100 / std::max<ui64>(1, stats.hits + stats.misses);
+	std::string cache = "text " + boost::lexical_cast<std::string>(hitRate) + "%";
+	graphics->fonts[FONT_SMALL]->renderTextLeft(screen, cache, yellow, Point(10, 30));
 }
 
 SDL_Keycode CGuiHandler::arrowToNum(SDL_Keycode key)
@@ -12,6 +12,7 @@
 //#include "../../lib/CStopWatch.h"
 #include "Geometries.h"
 #include "SDL_Extensions.h"
+#include "CScreenDamage.h"
 
 class CFramerateManager;
 class CGStatusBar;
@@ -64,8 +65,12 @@ private:
 	               textInterested;
 
 
+	CScreenDamage screenDamage;
+
 	void handleMouseButtonClick(CIntObjectList & interestedObjs, EIntObjMouseBtnType btn, bool isPressed);
 	void processLists(const ui16 activityFlag, std::function<void (std::list<CIntObject*> *)> cb);
+	bool updateScreenTexture(); //sends changed parts of screen to texture, returns false if nothing changed
+	void invalidateShownArea(IShowable * object); //object drew itself to screen, reports its area unless it does so itself
 public:
 	void handleElementActivate(CIntObject * elem, ui16 activityFlag);
 	void handleElementDeActivate(CIntObject * elem, ui16 activityFlag);
@@ -88,6 +93,8 @@ public:
 	~CGuiHandler();
 
 	void renderFrame();
+	void invalidateScreen(); //whole screen will be sent to texture and presented on next frame, needed when window content was lost
+	void invalidate(const SDL_Rect & area); //area of screen was drawn to and may have changed, only reported areas are sent to texture
 
 	void totalRedraw(); //forces total redraw (using showAll), sets a flag, method gets called at the end of the rendering
 	void simpleRedraw(); //update only top interface and draw background from buffer, sets a flag, method gets called at the end of the rendering
@@ -54,7 +54,8 @@ class IShowActivatable : public IShowable, public IActivatable
 {
 public:
 	//redraw parent flag - this int may be semi-transparent and require redraw of parent window
-	enum {BLOCK_ADV_HOTKEYS = 2, REDRAW_PARENT=8};
+	//reports changes flag - this int reports areas it has drawn to screen via GH.invalidate, otherwise whole int is compared every frame
+	enum {BLOCK_ADV_HOTKEYS = 2, REDRAW_PARENT=8, REPORTS_CHANGES=16};
 	int type; //bin flags using etype
 	IShowActivatable();
 	virtual ~IShowActivatable(){};
@@ -0,0 +1,61 @@
+/*
+ * CRenderedTextCache.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+/// Rendered strings of one font keyed by string and colour, least recently used ones are dropped when cache is full
+/// TRendered owns rendered text, it is destroyed when string is dropped from cache
+template<typename TRendered>
+class CRenderedTextCache
+{
+	typedef std::pair<std::string, ui32> TKey;
+	typedef std::list<std::pair<TKey, TRendered>> TEntries; // most recently used first
+
+	const size_t capacity;
+
+	TEntries entries;
+	std::unordered_map<TKey, typename TEntries::iterator, boost::hash<TKey>> index;
+
+public:
+	boost::mutex mx;
+
+	explicit CRenderedTextCache(size_t capacity):
+		capacity(capacity)
+	{
+	}
+
+	/// Returns nullptr if string was not rendered yet, found entry becomes most recently used
+	const TRendered * find(const std::string & data, ui32 color)
+	{
+		auto it = index.find(TKey(data, color));
+		if(it == index.end())
+			return nullptr;
+
+		entries.splice(entries.begin(), entries, it->second);
+		return &it->second->second;
+	}
+
+	const TRendered & insert(const std::string & data, ui32 color, TRendered rendered)
+	{
+		if(entries.size() >= capacity)
+		{
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+
+		entries.push_front(std::make_pair(TKey(data, color), std::move(rendered)));
+		index[entries.front().first] = entries.begin();
+		return entries.front().second;
+	}
+
+	size_t size() const
+	{
+		return entries.size();
+	}
+};
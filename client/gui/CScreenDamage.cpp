@@ -0,0 +1,151 @@
+/*
+ * CScreenDamage.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CScreenDamage.h"
+
+const int CScreenDamage::BLOCK_WIDTH;
+const int CScreenDamage::BLOCK_HEIGHT;
+
+CScreenDamage::CScreenDamage()
+	: width(0), height(0), rowBytes(0), valid(false)
+{
+}
+
+void CScreenDamage::invalidateAll()
+{
+	valid = false;
+}
+
+void CScreenDamage::invalidate(const SDL_Rect & area)
+{
+	if(area.w > 0 && area.h > 0)
+		reported.push_back(area);
+}
+
+void CScreenDamage::markReportedBlocks()
+{
+	const int columns = (width + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+	const int rows = (height + BLOCK_HEIGHT - 1) / BLOCK_HEIGHT;
+	dirtyBlocks.assign(static_cast<size_t>(columns) * rows, 0);
+
+	for(const SDL_Rect & area : reported)
+	{
+		// areas may be partially or completely off screen
+		const int left = std::max(0, area.x) / BLOCK_WIDTH;
+		const int top = std::max(0, area.y) / BLOCK_HEIGHT;
+		const int right = std::min(width, area.x + area.w);
+		const int bottom = std::min(height, area.y + area.h);
+		if(right <= 0 || bottom <= 0)
+			continue;
+
+		for(int row = top; row * BLOCK_HEIGHT < bottom; row++)
+			for(int column = left; column * BLOCK_WIDTH < right; column++)
+				dirtyBlocks[row * columns + column] = 1;
+	}
+	reported.clear();
+}
+
+const std::vector<SDL_Rect> & CScreenDamage::update(const void * pixels, int Width, int Height, int pitch, int bytesPerPixel)
+{
+	const ui8 * source = static_cast<const ui8 *>(pixels);
+	changed.clear();
+
+	if(!valid || Width != width || Height != height || Width * bytesPerPixel != rowBytes)
+	{
+		width = Width;
+		height = Height;
+		rowBytes = width * bytesPerPixel;
+		previous.resize(static_cast<size_t>(rowBytes) * height);
+		for(int y = 0; y < height; y++)
+			std::copy_n(source + y * pitch, rowBytes, previous.data() + y * rowBytes);
+
+		valid = true;
+		reported.clear();
+		SDL_Rect all = {0, 0, width, height};
+		changed.push_back(all);
+		return changed;
+	}
+
+	// nothing was drawn, nothing has to be compared
+	if(reported.empty())
+		return changed;
+
+	markReportedBlocks();
+	const int blocksInRow = (width + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+
+	open.clear();
+	for(int y = 0; y < height; y += BLOCK_HEIGHT)
+	{
+		const int rows = std::min(BLOCK_HEIGHT, height - y);
+		const ui8 * dirty = dirtyBlocks.data() + (y / BLOCK_HEIGHT) * blocksInRow;
+		band.clear();
+
+		for(int x = 0; x < width; x += BLOCK_WIDTH)
+		{
+			if(!dirty[x / BLOCK_WIDTH])
+				continue;
+
+			const int columns = std::min(BLOCK_WIDTH, width - x);
+			const size_t offset = static_cast<size_t>(x) * bytesPerPixel;
+			const size_t bytes = static_cast<size_t>(columns) * bytesPerPixel;
+
+			int row = 0;
+			while(row < rows && !memcmp(source + (y + row) * pitch + offset, previous.data() + (y + row) * rowBytes + offset, bytes))
+				row++;
+
+			if(row == rows)
+				continue;
+
+			// rows above first difference are same, copy only the rest
+			for(; row < rows; row++)
+				memcpy(previous.data() + (y + row) * rowBytes + offset, source + (y + row) * pitch + offset, bytes);
+
+			if(!band.empty() && band.back().x + band.back().w == x)
+			{
+				band.back().w += columns;
+			}
+			else
+			{
+				SDL_Rect block = {x, y, columns, rows};
+				band.push_back(block);
+			}
+		}
+		mergeBand(y);
+	}
+	vstd::concatenate(changed, open);
+	return changed;
+}
+
+void CScreenDamage::mergeBand(int y)
+{
+	// areas that span same columns in consecutive rows of blocks become one rectangle
+	std::vector<SDL_Rect> stillOpen;
+	for(const SDL_Rect & rect : band)
+	{
+		auto sameColumns = [&](const SDL_Rect & area)
+		{
+			return area.x == rect.x && area.w == rect.w && area.y + area.h == y;
+		};
+
+		auto area = boost::find_if(open, sameColumns);
+		if(area != open.end())
+		{
+			area->h += rect.h;
+			stillOpen.push_back(*area);
+			open.erase(area);
+		}
+		else
+		{
+			stillOpen.push_back(rect);
+		}
+	}
+	vstd::concatenate(changed, open);
+	open.swap(stillOpen);
+}
@@ -0,0 +1,46 @@
+/*
+ * CScreenDamage.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include <SDL_rect.h>
+
+/// Finds parts of screen surface that changed since they were last sent to screen texture
+/// Widgets report areas they have drawn to, only these areas are compared with copy of previous frame block by block
+class CScreenDamage
+{
+public:
+	CScreenDamage();
+
+	/// Next update reports whole screen, needed when texture content is lost (e.g. window was recreated)
+	void invalidateAll();
+	/// Area will be compared with previous frame on next update, areas that were not reported are assumed unchanged
+	void invalidate(const SDL_Rect & area);
+
+	/// Compares reported areas with previous frame and remembers them as new previous frame
+	/// Returns changed areas, adjacent changed blocks are merged into rectangles
+	const std::vector<SDL_Rect> & update(const void * pixels, int width, int height, int pitch, int bytesPerPixel);
+
+private:
+	static const int BLOCK_WIDTH = 64;
+	static const int BLOCK_HEIGHT = 16;
+
+	std::vector<ui8> previous;
+	int width, height, rowBytes;
+	bool valid;
+
+	std::vector<SDL_Rect> reported;
+	std::vector<ui8> dirtyBlocks; //blocks covered by reported areas, row by row
+	std::vector<SDL_Rect> changed;
+	std::vector<SDL_Rect> open; //changed areas that may still grow downwards
+	std::vector<SDL_Rect> band; //changed blocks of current row of blocks
+
+	void markReportedBlocks();
+	void mergeBand(int y);
+};
@@ -13,11 +13,94 @@
 #include <SDL_ttf.h>
 
 #include "SDL_Pixels.h"
+#include "CRenderedTextCache.h"
 #include "../../lib/JsonNode.h"
 #include "../../lib/vcmi_endian.h"
 #include "../../lib/filesystem/Filesystem.h"
 #include "../../lib/CGeneralTextHandler.h"
 
+// screens with more distinct labels than this re-render all of them each frame, see CRenderedTextCacheBenchmark
+static const size_t MAX_CACHED_STRINGS = 512;
+// glyphs of bitmap fonts with negative offsets may stick out of width of the string
+static const int TEXT_SURFACE_MARGIN = 4;
+
+static std::atomic<ui64> textCacheHits(0);
+static std::atomic<ui64> textCacheMisses(0);
+
+/// String rendered by font onto transparent surface
+struct RenderedText
+{
+	std::unique_ptr<SDL_Surface, void (*)(SDL_Surface*)> surface;
+	Point offset; // topleft corner of the text on surface
+	Point size; // size of the text, used for alignment
+
+	RenderedText(SDL_Surface * surface):
+		surface(surface, SDL_FreeSurface)
+	{}
+};
+
+static ui32 colorKey(const SDL_Color & color)
+{
+	// alpha is never used by fonts
+	return (color.r << 16) | (color.g << 8) | color.b;
+}
+
+IFont::IFont():
+	cache(new CRenderedTextCache<RenderedText>(MAX_CACHED_STRINGS))
+{}
+
+IFont::~IFont()
+{}
+
+TextCacheStats IFont::getCacheStats()
+{
+	TextCacheStats ret;
+	ret.hits = textCacheHits;
+	ret.misses = textCacheMisses;
+	return ret;
+}
+
+SDL_Surface * IFont::renderTextSurface(const std::string & data, const SDL_Color & color, Point & offset) const
+{
+	offset = Point(TEXT_SURFACE_MARGIN, 0);
+
+	SDL_Surface * rendered = CSDL_Ext::createSurfaceWithBpp<4>(getStringWidth(data) + 2 * TEXT_SURFACE_MARGIN, getLineHeight());
+	renderText(rendered, data, color, offset);
+	return rendered;
+}
+
+void IFont::renderCached(SDL_Surface * surface, const std::string & data, const SDL_Color & color, const Point & pos, EAnchor anchor) const
+{
+	if(data.empty())
+		return;
+
+	assert(surface);
+
+	boost::unique_lock<boost::mutex> lock(cache->mx);
+
+	const RenderedText * entry = cache->find(data, colorKey(color));
+	if(entry)
+		textCacheHits++;
+	else
+	{
+		textCacheMisses++;
+
+		Point offset;
+		RenderedText rendered(renderTextSurface(data, color, offset));
+		rendered.offset = offset;
+		rendered.size = Point(getStringWidth(data), getLineHeight());
+		assert(rendered.surface);
+
+		// text surfaces are mostly transparent, RLE skips empty parts when blitting
+		SDL_SetSurfaceRLE(rendered.surface.get(), 1);
+		entry = &cache->insert(data, colorKey(color), std::move(rendered));
+	}
+
+	Point topLeft = pos - entry->size * static_cast<int>(anchor) / 2;
+	Rect dest(topLeft - entry->offset, Point(entry->surface->w, entry->surface->h));
+	SDL_BlitSurface(entry->surface.get(), nullptr, surface, &dest);
+}
+
 size_t IFont::getStringWidth(const std::string & data) const
 {
 	size_t width = 0;
@@ -31,19 +114,17 @@ size_t IFont::getStringWidth(const std::string & data) const
 
 void IFont::renderTextLeft(SDL_Surface * surface, const std::string & data, const SDL_Color & color, const Point & pos) const
 {
-	renderText(surface, data, color, pos);
+	renderCached(surface, data, color, pos, TOPLEFT);
 }
 
 void IFont::renderTextRight(SDL_Surface * surface, const std::string & data, const SDL_Color & color, const Point & pos) const
 {
-	Point size(getStringWidth(data), getLineHeight());
-	renderText(surface, data, color, pos - size);
+	renderCached(surface, data, color, pos, BOTTOMRIGHT);
 }
 
 void IFont::renderTextCenter(SDL_Surface * surface, const std::string & data, const SDL_Color & color, const Point & pos) const
 {
-	Point size(getStringWidth(data), getLineHeight());
-	renderText(surface, data, color, pos - size / 2);
+	renderCached(surface, data, color, pos, CENTER);
 }
 
 void IFont::renderTextLinesLeft(SDL_Surface * surface, const std::vector<std::string> & data, const SDL_Color & color, const Point & pos) const
@@ -86,12 +167,15 @@ std::array<CBitmapFont::BitmapChar, CBitmapFont::totalChars> CBitmapFont::loadCh
 	std::array<BitmapChar, totalChars> ret;
 
 	size_t offset = 32;
+	ui32 atlasPos = 0;
 
 	for (auto & elem : ret)
 	{
 		elem.leftOffset =  read_le_u32(data.first.get() + offset); offset+=4;
 		elem.width =       read_le_u32(data.first.get() + offset); offset+=4;
 		elem.rightOffset = read_le_u32(data.first.get() + offset); offset+=4;
+		elem.atlasPos = atlasPos;
+		atlasPos += elem.width;
 	}
 
 	for (auto & elem : ret)
@@ -104,10 +188,37 @@ std::array<CBitmapFont::BitmapChar, CBitmapFont::totalChars> CBitmapFont::loadCh
 	return ret;
 }
 
+SDL_Surface * CBitmapFont::createAtlas() const
+{
+	const BitmapChar & last = chars.back();
+	SDL_Surface * ret = SDL_CreateRGBSurface(SDL_SWSURFACE, std::max<int>(1, last.atlasPos + last.width), height, 8, 0, 0, 0, 0);
+
+	// index 0 is transparent, 1 is black "shadow" and 255 - text colour
+	SDL_Color palette[256] = {};
+	palette[1].a = SDL_ALPHA_OPAQUE;
+	palette[255].a = SDL_ALPHA_OPAQUE;
+	SDL_SetPaletteColors(ret->format->palette, palette, 0, 256);
+	SDL_SetColorKey(ret, SDL_TRUE, 0);
+
+	for(const BitmapChar & character : chars)
+	{
+		for(int dy = 0; dy < height; dy++)
+		{
+			const ui8 * srcLine = character.pixels + dy * character.width;
+			ui8 * dstLine = static_cast<ui8 *>(ret->pixels) + dy * ret->pitch + character.atlasPos;
+
+			for(ui32 dx = 0; dx < character.width; dx++)
+				dstLine[dx] = (srcLine[dx] == 1 || srcLine[dx] == 255) ? srcLine[dx] : 0;
+		}
+	}
+	return ret;
+}
+
 CBitmapFont::CBitmapFont(const std::string & filename):
     data(CResourceHandler::get()->load(ResourceID("data/" + filename, EResType::BMP_FONT))->readAll()),
     chars(loadChars()),
-    height(data.first.get()[5])
+    height(data.first.get()[5]),
+    atlas(createAtlas(), SDL_FreeSurface)
 {}
 
 size_t CBitmapFont::getLineHeight() const
@@ -129,50 +240,22 @@ size_t CBitmapFont::getGlyphWidth(const char * data) const
 
 void CBitmapFont::renderCharacter(SDL_Surface * surface, const BitmapChar & character, const SDL_Color & color, int &posX, int &posY) const
 {
-	Rect clipRect;
-	SDL_GetClipRect(surface, &clipRect);
-
 	posX += character.leftOffset;
 
-	TColorPutter colorPutter = CSDL_Ext::getPutterFor(surface, 0);
-
-	Uint8 bpp = surface->format->BytesPerPixel;
-
-	// start of line, may differ from 0 due to end of surface or clipped surface
-	int lineBegin = std::max<int>(0, clipRect.y - posY);
-	int lineEnd   = std::min<int>(height, clipRect.y + clipRect.h - posY - 1);
-
-	// start end end of each row, may differ from 0
-	int rowBegin = std::max<int>(0, clipRect.x - posX);
-	int rowEnd   = std::min<int>(character.width, clipRect.x + clipRect.w - posX - 1);
-
-	//for each line in symbol
-	for(int dy = lineBegin; dy <lineEnd; dy++)
+	if (character.width != 0)
 	{
-		Uint8 *dstLine = (Uint8*)surface->pixels;
-		Uint8 *srcLine = character.pixels;
-
-		// shift source\destination pixels to current position
-		dstLine += (posY+dy) * surface->pitch + posX * bpp;
-		srcLine += dy * character.width;
-
-		//for each column in line
-		for(int dx = rowBegin; dx < rowEnd; dx++)
+		SDL_Color & textColor = atlas->format->palette->colors[255];
+		if (textColor.r != color.r || textColor.g != color.g || textColor.b != color.b)
 		{
-			Uint8* dstPixel = dstLine + dx*bpp;
-			switch(srcLine[dx])
-			{
-			case 1: //black "shadow"
-				colorPutter(dstPixel, 0, 0, 0);
-				break;
-			case 255: //text colour
-				colorPutter(dstPixel, color.r, color.g, color.b);
-				break;
-			default :
-				break; //transparency
-			}
+			SDL_Color opaque = {color.r, color.g, color.b, SDL_ALPHA_OPAQUE};
+			SDL_SetPaletteColors(atlas->format->palette, &opaque, 255, 1);
 		}
+
+		Rect srcRect(character.atlasPos, 0, character.width, height);
+		Rect dstRect(posX, posY, character.width, height);
+		SDL_BlitSurface(atlas.get(), &srcRect, surface, &dstRect);
 	}
+
 	posX += character.width;
 	posX += character.rightOffset;
 }
@@ -191,8 +274,6 @@ void CBitmapFont::renderText(SDL_Surface * surface, const std::string & data, co
 	//assert(data[0] != '{');
 	//assert(data[data.size()-1] != '}');
 
-	SDL_LockSurface(surface);
-
 	for(size_t i=0; i<data.size(); i += Unicode::getCharacterSize(data[i]))
 	{
 		std::string localChar = Unicode::fromUnicode(data.substr(i, Unicode::getCharacterSize(data[i])));
@@ -200,7 +281,6 @@ void CBitmapFont::renderText(SDL_Surface * surface, const std::string & data, co
 		if (localChar.size() == 1)
 			renderCharacter(surface, chars[ui8(localChar[0])], color, posX, posY);
 	}
-	SDL_UnlockSurface(surface);
 }
 
 std::pair<std::unique_ptr<ui8[]>, ui64> CTrueTypeFont::loadData(const JsonNode & config)
@@ -289,6 +369,69 @@ void CTrueTypeFont::renderText(SDL_Surface * surface, const std::string & data,
 	}
 }
 
+SDL_Surface * CTrueTypeFont::renderTextSurface(const std::string & data, const SDL_Color & color, Point & offset) const
+{
+	offset = Point(0, 0);
+
+	auto render = [&](const SDL_Color & textColor) -> SDL_Surface *
+	{
+		SDL_Color opaque = {textColor.r, textColor.g, textColor.b, SDL_ALPHA_OPAQUE};
+		SDL_Surface * rendered;
+		if (blended)
+			rendered = TTF_RenderUTF8_Blended(font.get(), data.c_str(), opaque);
+		else
+			rendered = TTF_RenderUTF8_Solid(font.get(), data.c_str(), opaque);
+		assert(rendered);
+		return rendered;
+	};
+
+	SDL_Surface * text = render(color);
+
+	if (color.r == 0 || color.g == 0 || color.b == 0) // same condition as in renderText - no shadow
+		return text;
+
+	SDL_Color black = { 0, 0, 0, SDL_ALPHA_OPAQUE};
+	SDL_Surface * shadow = render(black);
+	SDL_Surface * ret = CSDL_Ext::createSurfaceWithBpp<4>(text->w + 1, text->h + 1);
+
+	Rect shadowRect(1, 1, shadow->w, shadow->h);
+	if (!blended)
+	{
+		// opaque pixels only, blitting both in order gives same result as drawing on screen
+		SDL_BlitSurface(shadow, nullptr, ret, &shadowRect);
+		SDL_BlitSurface(text, nullptr, ret, nullptr);
+	}
+	else
+	{
+		// SDL blending does not handle transparent destination, text is composed on top of shadow here
+		SDL_SetSurfaceBlendMode(shadow, SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(shadow, nullptr, ret, &shadowRect);
+
+		for (int y = 0; y < text->h; y++)
+		{
+			for (int x = 0; x < text->w; x++)
+			{
+				Uint32 & dstPixel = static_cast<Uint32 *>(ret->pixels)[y * ret->pitch / 4 + x];
+				Uint32 srcPixel = static_cast<const Uint32 *>(text->pixels)[y * text->pitch / 4 + x];
+
+				SDL_Color src, dst;
+				SDL_GetRGBA(srcPixel, text->format, &src.r, &src.g, &src.b, &src.a);
+				SDL_GetRGBA(dstPixel, ret->format, &dst.r, &dst.g, &dst.b, &dst.a);
+				if (src.a == 0)
+					continue;
+
+				// shadow is black, so only text contributes to colour
+				int alpha = src.a + dst.a * (255 - src.a) / 255;
+				dstPixel = SDL_MapRGBA(ret->format, src.r * src.a / alpha, src.g * src.a / alpha, src.b * src.a / alpha, alpha);
+			}
+		}
+	}
+
+	SDL_FreeSurface(shadow);
+	SDL_FreeSurface(text);
+	return ret;
+}
+
 size_t CBitmapHanFont::getCharacterDataOffset(size_t index) const
 {
 	size_t rowSize  = (size + 7) / 8; // 1 bit per pixel, rounded up
@@ -313,6 +456,8 @@ void CBitmapHanFont::renderCharacter(SDL_Surface * surface, int characterIndex,
 	TColorPutter colorPutter = CSDL_Ext::getPutterFor(surface, 0);
 	Uint8 bpp = surface->format->BytesPerPixel;
 
+	SDL_LockSurface(surface);
+
 	// start of line, may differ from 0 due to end of surface or clipped surface
 	int lineBegin = std::max<int>(0, clipRect.y - posY);
 	int lineEnd   = std::min<int>(size, clipRect.y + clipRect.h - posY);
@@ -342,6 +487,8 @@ void CBitmapHanFont::renderCharacter(SDL_Surface * surface, int characterIndex,
 				colorPutter(dstPixel, color.r, color.g, color.b);
 		}
 	}
+	SDL_UnlockSurface(surface);
+
 	posX += size + 1;
 }
 
@@ -350,8 +497,7 @@ void CBitmapHanFont::renderText(SDL_Surface * surface, const std::string & data,
 	int posX = pos.x;
 	int posY = pos.y;
 
-	SDL_LockSurface(surface);
-
+	// surface is locked only by own characters, fallback font blits its characters
 	for(size_t i=0; i<data.size(); i += Unicode::getCharacterSize(data[i]))
 	{
 		std::string localChar = Unicode::fromUnicode(data.substr(i, Unicode::getCharacterSize(data[i])));
@@ -362,7 +508,6 @@ void CBitmapHanFont::renderText(SDL_Surface * surface, const std::string & data,
 		if (localChar.size() == 2)
 			renderCharacter(surface, getCharacterIndex(localChar[0], localChar[1]), color, posX, posY);
 	}
-	SDL_UnlockSurface(surface);
 }
 
 CBitmapHanFont::CBitmapHanFont(const JsonNode &config):
@@ -19,16 +19,39 @@ typedef struct _TTF_Font TTF_Font;
 
 class CBitmapFont;
 class CBitmapHanFont;
+struct RenderedText;
+template<typename TRendered> class CRenderedTextCache;
+
+/// Usage of caches of rendered strings, summed for all fonts
+struct TextCacheStats
+{
+	ui64 hits;
+	ui64 misses;
+};
 
 class IFont
 {
+	/// recently rendered strings, all renderText* functions blit text from here
+	const std::unique_ptr<CRenderedTextCache<RenderedText>> cache;
+
+	/// which point of the text is at given position
+	enum EAnchor {TOPLEFT = 0, CENTER = 1, BOTTOMRIGHT = 2};
+
+	void renderCached(SDL_Surface * surface, const std::string & data, const SDL_Color & color, const Point & pos, EAnchor anchor) const;
+
 protected:
 	/// Internal function to render font, see renderTextLeft
 	virtual void renderText(SDL_Surface * surface, const std::string & data, const SDL_Color & color, const Point & pos) const = 0;
 
+	/// Renders string on new transparent surface which is then stored in cache
+	/// offset - position of topleft corner of the text on returned surface
+	virtual SDL_Surface * renderTextSurface(const std::string & data, const SDL_Color & color, Point & offset) const;
+
 public:
-	virtual ~IFont()
-	{}
+	IFont();
+	virtual ~IFont();
+
+	static TextCacheStats getCacheStats();
 
 	/// Returns height of font
 	virtual size_t getLineHeight() const = 0;
@@ -68,6 +91,7 @@ class CBitmapFont : public IFont
 		ui32 width;
 		si32 rightOffset;
 		ui8 *pixels; // pixels of this character, part of BitmapFont::data
+		ui32 atlasPos; // horizontal position of this character in atlas
 	};
 
 	const std::pair<std::unique_ptr<ui8[]>, ui64> data;
@@ -75,7 +99,11 @@ class CBitmapFont : public IFont
 	const std::array<BitmapChar, totalChars> chars;
 	const ui8 height;
 
+	/// all characters in one paletted surface, text colour is set in palette before blitting
+	const std::unique_ptr<SDL_Surface, void (*)(SDL_Surface*)> atlas;
+
 	std::array<BitmapChar, totalChars> loadChars() const;
+	SDL_Surface * createAtlas() const;
 
 	void renderCharacter(SDL_Surface * surface, const BitmapChar & character, const SDL_Color & color, int &posX, int &posY) const;
 
@@ -111,6 +139,7 @@ public:
 	size_t getGlyphWidth(const char * data) const override;
 };
 
+/// strings are rendered whole by SDL_ttf, which applies kerning between glyphs
 class CTrueTypeFont : public IFont
 {
 	const std::pair<std::unique_ptr<ui8[]>, ui64> data;
@@ -123,6 +152,7 @@ class CTrueTypeFont : public IFont
 	int getFontStyle(const JsonNode & config);
 
 	void renderText(SDL_Surface * surface, const std::string & data, const SDL_Color & color, const Point & pos) const override;
+	SDL_Surface * renderTextSurface(const std::string & data, const SDL_Color & color, Point & offset) const override;
 public:
 	CTrueTypeFont(const JsonNode & fontConfig);
 
@@ -383,6 +383,7 @@ void CTerrainRect::show(SDL_Surface * to)
 			info.movement = int3(moveX, moveY, 0);
 
 		lastRedrawStatus = CGI->mh->drawTerrainRectNew(to, &info);
+		GH.invalidate(pos);
 		if (fadeAnim->isFading())
 		{
 			Rect r(pos);
@@ -555,6 +556,7 @@ CAdvMapInt::CAdvMapInt():
 	swipeTargetPosition(int3(-1, -1, -1))
 {
   adventureInt = this;
+	type |= REPORTS_CHANGES;
 	pos.x = pos.y = 0;
 	pos.w = screen->w;
 	pos.h = screen->h;
@@ -958,6 +960,7 @@ void CAdvMapInt::deactivate()
 void CAdvMapInt::showAll(SDL_Surface * to)
 {
 	blitAt(bg,0,0,to);
+	GH.invalidate(pos);
 
 	if(state != INGAME)
 		return;
@@ -1050,19 +1053,28 @@ void CAdvMapInt::show(SDL_Surface * to)
 
 		terrain.show(to);
 		for(int i = 0; i < 4; i++)
+		{
 			gems[i]->showAll(to);
+			GH.invalidate(gems[i]->pos);
+		}
 		updateScreen=false;
-		LOCPLINT->cingconsole->show(to);
+		LOCPLINT->cingconsole->show(to); //drawn over terrain
 	}
 	else if (terrain.needsAnimUpdate())
 	{
 		terrain.showAnim(to);
 		for(int i = 0; i < 4; i++)
+		{
 			gems[i]->showAll(to);
+			GH.invalidate(gems[i]->pos);
+		}
 	}
 
+	// only areas drawn every frame are reported, rest of the map is redrawn through redraw() of its widgets
 	infoBar.show(to);
 	statusbar.showAll(to);
+	GH.invalidate(infoBar.pos);
+	GH.invalidate(statusbar.pos);
 }
 
 void CAdvMapInt::handleMapScrollingUpdate()
@@ -22,6 +22,7 @@
 #include "../CMusicHandler.h"
 #include "../CPlayerInterface.h"
 #include "../Graphics.h"
+#include "../gui/CAnimation.h"
 #include "../gui/CGuiHandler.h"
 #include "../gui/SDL_Extensions.h"
 #include "../windows/InfoWindows.h"
@@ -511,11 +512,13 @@ void CCastleBuildings::recreate()
 		}
 	}
 
+	std::vector<const CStructure *> visibleStructures;
+
 	for(const CStructure * structure : town->town->clientInfo.structures)
 	{
 		if (!structure->building)
 		{
-			buildings.push_back(new CBuildingRect(this, town, structure));
+			visibleStructures.push_back(structure);
 			continue;
 		}
 		if (vstd::contains(buildingsCopy, structure->building->bid))
@@ -534,8 +537,17 @@ void CCastleBuildings::recreate()
 			     < build->getDistance(b->building->bid);
 		});
 
-		buildings.push_back(new CBuildingRect(this, town, toAdd));
+		visibleStructures.push_back(toAdd);
 	}
+
+	//read animations of all buildings at once
+	std::vector<std::string> animations;
+	for(const CStructure * structure : visibleStructures)
+		animations.push_back(structure->defName);
+	CAnimation::prefetch(animations);
+
+	for(const CStructure * structure : visibleStructures)
+		buildings.push_back(new CBuildingRect(this, town, structure));
 	boost::sort(buildings, [] (const CBuildingRect * a, const CBuildingRect * b)
 	{
 		return *a < *b;
@@ -0,0 +1,141 @@
+/*
+ * CFogOfWarMap.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CFogOfWarMap.h"
+
+CFogOfWarMap::CFogOfWarMap()
+	: rowWords(0)
+{
+}
+
+void CFogOfWarMap::resize(const int3 & Sizes)
+{
+	sizes = Sizes;
+	rowWords = (sizes.x + WORD_BITS - 1) / WORD_BITS;
+	words.assign(static_cast<size_t>(rowWords) * sizes.y * sizes.z, 0);
+}
+
+int3 CFogOfWarMap::getSizes() const
+{
+	return sizes;
+}
+
+void CFogOfWarMap::setVisible(const int3 & pos, bool visible)
+{
+	const TWord bit = TWord(1) << (pos.x % WORD_BITS);
+	if(visible)
+		words[wordIndex(pos.x, pos.y, pos.z)] |= bit;
+	else
+		words[wordIndex(pos.x, pos.y, pos.z)] &= ~bit;
+}
+
+void CFogOfWarMap::reveal(const int3 & center, int radius, int3::EDistanceFormula formula)
+{
+	if(radius == -1)
+	{
+		for(int z = 0; z < sizes.z; z++)
+			for(int y = 0; y < sizes.y; y++)
+				revealSpan(0, sizes.x - 1, y, z);
+		return;
+	}
+
+	const std::vector<int> spans = getRangeSpans(radius, formula);
+	const int rows = spans.size();
+	for(int dy = 1 - rows; dy < rows; dy++)
+	{
+		const int y = center.y + dy;
+		if(y < 0 || y >= sizes.y)
+			continue;
+
+		const int halfWidth = spans[std::abs(dy)];
+		const int x1 = std::max(center.x - halfWidth, 0);
+		const int x2 = std::min(center.x + halfWidth, sizes.x - 1);
+		if(x1 <= x2)
+			revealSpan(x1, x2, y, center.z);
+	}
+}
+
+void CFogOfWarMap::revealSpan(int x1, int x2, int y, int z)
+{
+	TWord * row = &words[wordIndex(0, y, z)];
+	const int first = x1 / WORD_BITS;
+	const int last = x2 / WORD_BITS;
+	const TWord firstMask = ~TWord(0) << (x1 % WORD_BITS);
+	const TWord lastMask = ~TWord(0) >> (WORD_BITS - 1 - x2 % WORD_BITS);
+
+	if(first == last)
+	{
+		row[first] |= firstMask & lastMask;
+		return;
+	}
+
+	row[first] |= firstMask;
+	for(int i = first + 1; i < last; i++)
+		row[i] = ~TWord(0);
+	row[last] |= lastMask;
+}
+
+bool CFogOfWarMap::operator==(const CFogOfWarMap & other) const
+{
+	return sizes == other.sizes && words == other.words;
+}
+
+std::vector<int> CFogOfWarMap::getRangeSpans(int radius, int3::EDistanceFormula formula)
+{
+	// rows never get wider with growing distance from center, so whole area takes O(radius) distance checks
+	std::vector<int> spans;
+	const int3 center;
+	int halfWidth = radius;
+	for(int dy = 0; dy <= radius; dy++)
+	{
+		while(halfWidth >= 0 && center.dist(int3(halfWidth, dy, 0), formula) > static_cast<ui32>(radius))
+			halfWidth--;
+
+		if(halfWidth < 0)
+			break;
+		spans.push_back(halfWidth);
+	}
+	return spans;
+}
+
+std::vector<TileRun> TileRun::fromTiles(const std::unordered_set<int3, ShashInt3> & tiles)
+{
+	std::vector<int3> sorted(tiles.begin(), tiles.end());
+	boost::sort(sorted);
+
+	std::vector<TileRun> runs;
+	for(const int3 & tile : sorted)
+	{
+		if(!runs.empty())
+		{
+			TileRun & run = runs.back();
+			if(run.z == tile.z && run.y == tile.y && run.x + run.length == tile.x && run.length < std::numeric_limits<ui16>::max())
+			{
+				run.length++;
+				continue;
+			}
+		}
+
+		TileRun run;
+		run.x = tile.x;
+		run.y = tile.y;
+		run.z = tile.z;
+		run.length = 1;
+		runs.push_back(run);
+	}
+	return runs;
+}
+
+void TileRun::toTiles(const std::vector<TileRun> & runs, std::unordered_set<int3, ShashInt3> & tiles)
+{
+	for(const TileRun & run : runs)
+		for(int i = 0; i < run.length; i++)
+			tiles.insert(int3(run.x + i, run.y, run.z));
+}
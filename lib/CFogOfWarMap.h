@@ -0,0 +1,90 @@
+/*
+ * CFogOfWarMap.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "int3.h"
+
+/// Tiles visible for one team, one bit per tile
+/// Rows of each level are packed into 64-bit words, so spans of tiles are revealed by whole words
+class DLL_LINKAGE CFogOfWarMap
+{
+public:
+	CFogOfWarMap();
+
+	void resize(const int3 & sizes); //all tiles become hidden
+	int3 getSizes() const;
+
+	bool isVisible(const int3 & pos) const
+	{
+		return (words[wordIndex(pos.x, pos.y, pos.z)] >> (pos.x % WORD_BITS)) & 1;
+	}
+	void setVisible(const int3 & pos, bool visible);
+
+	/// Reveals all tiles within radius from center, radius -1 reveals entire map
+	void reveal(const int3 & center, int radius, int3::EDistanceFormula formula = int3::DIST_2D);
+
+	bool operator==(const CFogOfWarMap & other) const;
+
+	/// Half widths of rows of area within radius, indexed by vertical distance from center
+	static std::vector<int> getRangeSpans(int radius, int3::EDistanceFormula formula);
+
+	template <typename Handler> void serialize(Handler & h, const int version)
+	{
+		h & sizes;
+		h & words;
+		if(!h.saving)
+			rowWords = (sizes.x + WORD_BITS - 1) / WORD_BITS;
+	}
+
+private:
+	typedef ui64 TWord;
+	static const int WORD_BITS = 64;
+
+	int3 sizes;
+	int rowWords;
+	std::vector<TWord> words;
+
+	size_t wordIndex(int x, int y, int z) const
+	{
+		return (static_cast<size_t>(z) * sizes.y + y) * rowWords + x / WORD_BITS;
+	}
+	void revealSpan(int x1, int x2, int y, int z); //both ends inclusive
+};
+
+/// Horizontal run of tiles, sets of tiles revealed by sight are sent as runs instead of separate coordinates
+struct DLL_LINKAGE TileRun
+{
+	si16 x, y;
+	ui8 z;
+	ui16 length;
+
+	TileRun() : x(0), y(0), z(0), length(0) {}
+
+	static std::vector<TileRun> fromTiles(const std::unordered_set<int3, ShashInt3> & tiles);
+	static void toTiles(const std::vector<TileRun> & runs, std::unordered_set<int3, ShashInt3> & tiles);
+
+	template <typename Handler> static void serializeTiles(Handler & h, std::unordered_set<int3, ShashInt3> & tiles)
+	{
+		std::vector<TileRun> runs;
+		if(h.saving)
+			runs = fromTiles(tiles);
+		h & runs;
+		if(!h.saving)
+			toTiles(runs, tiles);
+	}
+
+	template <typename Handler> void serialize(Handler & h, const int version)
+	{
+		h & x;
+		h & y;
+		h & z;
+		h & length;
+	}
+};
@@ -28,6 +28,7 @@ class CGTeleport;
 class CMapHeader;
 struct TeamState;
 struct QuestInfo;
+class CFogOfWarMap;
 class int3;
 struct ShashInt3;
 
@@ -140,7 +141,7 @@ public:
 
 	int getResourceAmount(Res::ERes type) const;
 	TResources getResourceAmount() const;
-	const std::vector< std::vector< std::vector<ui8> > > & getVisibilityMap()const; //returns visibility map
+	const CFogOfWarMap & getVisibilityMap()const; //returns visibility map
 	const PlayerSettings * getPlayerSettings(PlayerColor color) const;
 };
 
@@ -35,7 +35,7 @@
 #include "mapping/CMapEditManager.h"
 #include "mapping/CMapService.h"
 #include "serializer/CTypeList.h"
-#include "serializer/CMemorySerializer.h"
+#include "serializer/CObjectCloner.h"
 #include "VCMIDirs.h"
 
 #ifdef min
@@ -707,8 +707,8 @@ void CGameState::init(StartInfo * si, bool allowSavingRandomMap)
 {
 	logGlobal->info("\tUsing random seed: %d", si->seedToBeUsed);
 	getRandomGenerator().setSeed(si->seedToBeUsed);
-	scenarioOps = CMemorySerializer::deepCopy(*si).release();
-	initialOpts = CMemorySerializer::deepCopy(*si).release();
+	scenarioOps = CObjectCloner::deepCopy(*si).release();
+	initialOpts = CObjectCloner::deepCopy(*si).release();
 	si = nullptr;
 
 	switch(scenarioOps->mode)
@@ -1517,29 +1517,13 @@ void CGameState::initFogOfWar()
 	logGlobal->debug("\tFog of war"); //FIXME: should be initialized after all bonuses are set
 	for(auto & elem : teams)
 	{
-		elem.second.fogOfWarMap.resize(map->width);
-		for(int g=0; g<map->width; ++g)
-			elem.second.fogOfWarMap[g].resize(map->height);
-
-		for(int g=-0; g<map->width; ++g)
-			for(int h=0; h<map->height; ++h)
-				elem.second.fogOfWarMap[g][h].resize(map->twoLevel ? 2 : 1, 0);
-
-		for(int g=0; g<map->width; ++g)
-			for(int h=0; h<map->height; ++h)
-				for(int v = 0; v < (map->twoLevel ? 2 : 1); ++v)
-					elem.second.fogOfWarMap[g][h][v] = 0;
+		elem.second.fogOfWarMap.resize(int3(map->width, map->height, map->twoLevel ? 2 : 1));
 
 		for(CGObjectInstance *obj : map->objects)
 		{
 			if(!obj || !vstd::contains(elem.second.players, obj->tempOwner)) continue; //not a flagged object
 
-			std::unordered_set<int3, ShashInt3> tiles;
-			getTilesInRange(tiles, obj->getSightCenter(), obj->getSightRadius(), obj->tempOwner, 1);
-			for(int3 tile : tiles)
-			{
-				elem.second.fogOfWarMap[tile.x][tile.y][tile.z] = 1;
-			}
+			elem.second.fogOfWarMap.reveal(obj->getSightCenter(), obj->getSightRadius());
 		}
 	}
 }
@@ -1972,6 +1956,17 @@ void CGameState::calculatePaths(const CGHeroInstance *hero, CPathsInfo &out)
 	pathfinder.calculatePaths();
 }
 
+void CGameState::updatePaths(const CGHeroInstance *hero, CPathsInfo &out)
+{
+	CPathfinder pathfinder(out, this, hero);
+	pathfinder.updatePaths();
+}
+
+void CGameState::updatePaths(const std::vector<std::pair<const CGHeroInstance *, CPathsInfo *>> & heroes)
+{
+	CPathfinder::updatePaths(this, heroes);
+}
+
 /**
  * Tells if the tile is guarded by a monster as well as the position
  * of the monster that will attack on it.
@@ -2029,7 +2024,7 @@ std::vector<CGObjectInstance*> CGameState::guardingCreatures (int3 pos) const
 
 int3 CGameState::guardingCreaturePosition (int3 pos) const
 {
-	return gs->map->guardingCreaturePositions[pos.x][pos.y][pos.z];
+	return gs->map->guardingCreaturePositions[gs->map->getTileIndex(pos)];
 }
 
 void CGameState::updateRumor()
@@ -2112,7 +2107,7 @@ bool CGameState::isVisible(int3 pos, PlayerColor player)
 	if(player.isSpectator())
 		return true;
 
-	return getPlayerTeam(player)->fogOfWarMap[pos.x][pos.y][pos.z];
+	return getPlayerTeam(player)->fogOfWarMap.isVisible(pos);
 }
 
 bool CGameState::isVisible( const CGObjectInstance *obj, boost::optional<PlayerColor> player )
@@ -2739,7 +2734,7 @@ std::vector<CGameState::CampaignHeroReplacement> CGameState::generateCampaignHer
 				{
 					auto hero = *it;
 					crossoverHeroes.removeHeroFromBothLists(hero);
-					campaignHeroReplacements.push_back(CampaignHeroReplacement(CMemorySerializer::deepCopy(*hero).release(), heroPlaceholder->id));
+					campaignHeroReplacements.push_back(CampaignHeroReplacement(CObjectCloner::deepCopy(*hero).release(), heroPlaceholder->id));
 				}
 			}
 		}
@@ -2775,7 +2770,7 @@ std::vector<CGameState::CampaignHeroReplacement> CGameState::generateCampaignHer
 		if(crossoverHeroes.heroesFromPreviousScenario.size() > i)
 		{
 			auto hero = crossoverHeroes.heroesFromPreviousScenario[i];
-			campaignHeroReplacements.push_back(CampaignHeroReplacement(CMemorySerializer::deepCopy(*hero).release(), heroPlaceholder->id));
+			campaignHeroReplacements.push_back(CampaignHeroReplacement(CObjectCloner::deepCopy(*hero).release(), heroPlaceholder->id));
 		}
 	}
 
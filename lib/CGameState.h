@@ -174,6 +174,8 @@ public:
 	PlayerRelations::PlayerRelations getPlayerRelations(PlayerColor color1, PlayerColor color2);
 	bool checkForVisitableDir(const int3 & src, const int3 & dst) const; //check if src tile is visitable from dst tile
 	void calculatePaths(const CGHeroInstance *hero, CPathsInfo &out); //calculates possible paths for hero, by default uses current hero position and movement left; returns pointer to newly allocated CPath or nullptr if path does not exists
+	void updatePaths(const CGHeroInstance *hero, CPathsInfo &out); //as calculatePaths, but reuses previous results stored in out; all changes since then must be reported with CPathsInfo::invalidate
+	void updatePaths(const std::vector<std::pair<const CGHeroInstance *, CPathsInfo *>> & heroes); //as above for several heroes at once, heroes are processed in parallel
 	int3 guardingCreaturePosition (int3 pos) const;
 	std::vector<CGObjectInstance*> guardingCreatures (int3 pos) const;
 	void updateRumor();
@@ -21,6 +21,7 @@
 #include "mapObjects/CObjectHandler.h"
 #include "StringConstants.h"
 #include "CStopWatch.h"
+#include "CThreadHelper.h"
 #include "IHandlerBase.h"
 #include "spells/CSpellHandler.h"
 #include "CSkillHandler.h"
@@ -327,12 +328,15 @@ CContentHandler::ContentTypeHandler::ContentTypeHandler(IHandlerBase * handler,
 	}
 }
 
-bool CContentHandler::ContentTypeHandler::preloadModData(std::string modName, std::vector<std::string> fileList, bool validate)
+JsonNode CContentHandler::ContentTypeHandler::parseModData(std::string modName, std::vector<std::string> fileList, bool & isValid)
 {
-	bool result;
-	JsonNode data = JsonUtils::assembleFromFiles(fileList, result);
+	JsonNode data = JsonUtils::assembleFromFiles(fileList, isValid);
 	data.setMeta(modName);
+	return data;
+}
 
+void CContentHandler::ContentTypeHandler::preloadModData(std::string modName, JsonNode data)
+{
 	ModInfo & modInfo = modData[modName];
 
 	for(auto entry : data.Struct())
@@ -359,7 +363,6 @@ bool CContentHandler::ContentTypeHandler::preloadModData(std::string modName, st
 			JsonUtils::merge(remoteConf, entry.second);
 		}
 	}
-	return result;
 }
 
 bool CContentHandler::ContentTypeHandler::loadMod(std::string modName, bool validate)
@@ -422,8 +425,14 @@ void CContentHandler::ContentTypeHandler::afterLoadFinalization()
 	handler->afterLoadFinalization();
 }
 
-CContentHandler::CContentHandler()
+CContentHandler::CContentHandler(bool templatesOnly)
 {
+	if(templatesOnly)
+	{
+		handlers.insert(std::make_pair("templates", ContentTypeHandler((IHandlerBase *)VLC->tplh, "template")));
+		return;
+	}
+
  	handlers.insert(std::make_pair("heroClasses", ContentTypeHandler(&VLC->heroh->classes, "heroClass")));
 	handlers.insert(std::make_pair("artifacts", ContentTypeHandler(VLC->arth, "artifact")));
 	handlers.insert(std::make_pair("creatures", ContentTypeHandler(VLC->creh, "creature")));
@@ -437,16 +446,6 @@ CContentHandler::CContentHandler()
 	//TODO: any other types of moddables?
 }
 
-bool CContentHandler::preloadModData(std::string modName, JsonNode modConfig, bool validate)
-{
-	bool result = true;
-	for(auto & handler : handlers)
-	{
-		result &= handler.second.preloadModData(modName, modConfig[handler.first].convertTo<std::vector<std::string> >(), validate);
-	}
-	return result;
-}
-
 bool CContentHandler::loadMod(std::string modName, bool validate)
 {
 	bool result = true;
@@ -473,20 +472,71 @@ void CContentHandler::afterLoadFinalization()
 	}
 }
 
-void CContentHandler::preloadData(CModInfo & mod)
+void CContentHandler::preloadData(const std::vector<CModInfo *> & mods)
 {
-	bool validate = (mod.validation != CModInfo::PASSED);
+	struct ParsedData
+	{
+		std::vector<std::string> files;
+		JsonNode data;
+		bool isValid;
+	};
 
-	// print message in format [<8-symbols checksum>] <modname>
-	logMod->info("\t\t[%08x]%s", mod.checksum, mod.name);
+	// parsed[mod][handler], handlers in same order as in map
+	std::vector<std::vector<ParsedData>> parsed(mods.size());
+	CTaskGroup tasks("mod data parsing");
 
-	if (validate && mod.identifier != "core")
+	for(size_t i = 0; i < mods.size(); i++)
 	{
-		if (!JsonUtils::validate(mod.config, "vcmi:mod", mod.identifier))
-			mod.validation = CModInfo::FAILED;
+		parsed[i].resize(handlers.size());
+		const JsonNode & modConfig = mods[i]->config;
+
+		size_t j = 0;
+		for(auto & handler : handlers)
+		{
+			parsed[i][j].files = modConfig[handler.first].convertTo<std::vector<std::string> >();
+
+			if(!parsed[i][j].files.empty())
+			{
+				tasks.run([&parsed, &mods, i, j]()
+				{
+					ParsedData & entry = parsed[i][j];
+					entry.data = ContentTypeHandler::parseModData(mods[i]->identifier, entry.files, entry.isValid);
+				});
+			}
+			else
+				parsed[i][j].isValid = true;
+			j++;
+		}
+	}
+
+	tasks.wait();
+
+	for(size_t i = 0; i < mods.size(); i++)
+	{
+		CModInfo & mod = *mods[i];
+		bool validate = (mod.validation != CModInfo::PASSED);
+
+		// print message in format [<8-symbols checksum>] <modname>
+		logMod->info("\t\t[%08x]%s", mod.checksum, mod.name);
+
+		if (validate && mod.identifier != "core")
+		{
+			if (!JsonUtils::validate(mod.config, "vcmi:mod", mod.identifier))
+				mod.validation = CModInfo::FAILED;
+		}
+
+		size_t j = 0;
+		for(auto & handler : handlers)
+		{
+			ParsedData & entry = parsed[i][j++];
+			if(!entry.isValid)
+				mod.validation = CModInfo::FAILED;
+
+			if(entry.files.empty())
+				entry.data.setMeta(mod.identifier);
+			handler.second.preloadModData(mod.identifier, std::move(entry.data));
+		}
 	}
-	if (!preloadModData(mod.identifier, mod.config, validate))
-		mod.validation = CModInfo::FAILED;
 }
 
 void CContentHandler::load(CModInfo & mod)
@@ -937,6 +987,32 @@ void CModHandler::initializeConfig()
 	loadConfigFromFile("defaultMods.json");
 }
 
+void CModHandler::calculateChecksums()
+{
+	CStopWatch timer;
+
+	// checksums of mods are independent, files of all mods are read in parallel
+	std::vector<ui32> checksums(activeMods.size());
+	CThreadPool::get().parallelFor("mod checksums", 0, activeMods.size(), [this, &checksums](size_t i)
+	{
+		logMod->trace("Generating checksum for %s", activeMods[i]);
+		checksums[i] = calculateModChecksum(activeMods[i], CResourceHandler::get(activeMods[i]));
+	});
+
+	for(size_t i = 0; i < activeMods.size(); i++)
+		allMods[activeMods[i]].updateChecksum(checksums[i]);
+	logMod->info("\tCalculating mod checksums: %d ms", timer.getDiff());
+}
+
+std::vector<std::pair<TModID, ui32>> CModHandler::getChecksums() const
+{
+	std::vector<std::pair<TModID, ui32>> ret;
+	ret.push_back(std::make_pair(coreMod.identifier, coreMod.checksum));
+	for(const TModID & modName : activeMods)
+		ret.push_back(std::make_pair(modName, allMods.at(modName).checksum));
+	return ret;
+}
+
 void CModHandler::load()
 {
 	CStopWatch totalTime, timer;
@@ -944,17 +1020,14 @@ void CModHandler::load()
 	CContentHandler content;
 	logMod->info("\tInitializing content handler: %d ms", timer.getDiff());
 
-	for(const TModID & modName : activeMods)
-	{
-		logMod->trace("Generating checksum for %s", modName);
-		allMods[modName].updateChecksum(calculateModChecksum(modName, CResourceHandler::get(modName)));
-	}
-
 	// first - load virtual "core" mod that contains all data
 	// TODO? move all data into real mods? RoE, AB, SoD, WoG
-	content.preloadData(coreMod);
+	std::vector<CModInfo *> mods;
+	mods.push_back(&coreMod);
 	for(const TModID & modName : activeMods)
-		content.preloadData(allMods[modName]);
+		mods.push_back(&allMods[modName]);
+
+	content.preloadData(mods);
 	logMod->info("\tParsing mod data: %d ms", timer.getDiff());
 
 	content.load(coreMod);
@@ -974,6 +1047,27 @@ void CModHandler::load()
 	content.afterLoadFinalization();
 	logMod->info("\tHandlers post-load finalization: %d ms ", timer.getDiff());
 	logMod->info("\tAll game content loaded in %d ms", totalTime.getDiff());
+	CThreadPool::get().logStats("Loading game content");
+}
+
+void CModHandler::loadTemplates()
+{
+	CStopWatch timer;
+
+	CContentHandler content(true);
+
+	std::vector<CModInfo *> mods;
+	mods.push_back(&coreMod);
+	for(const TModID & modName : activeMods)
+		mods.push_back(&allMods[modName]);
+
+	content.preloadData(mods);
+	for(CModInfo * mod : mods)
+		content.load(*mod);
+
+	content.loadCustom();
+	content.afterLoadFinalization();
+	logMod->info("\tLoading random map templates: %d ms", timer.getDiff());
 }
 
 void CModHandler::afterLoad()
@@ -134,27 +134,30 @@ class CContentHandler
 	public:
 		ContentTypeHandler(IHandlerBase * handler, std::string objectName);
 
+		/// reads and merges all files from fileList, does not touch handler and may be called from multiple threads at once
+		/// isValid is set to false if any of files is not valid
+		static JsonNode parseModData(std::string modName, std::vector<std::string> fileList, bool & isValid);
+
 		/// local version of methods in ContentHandler
 		/// returns true if loading was successful
-		bool preloadModData(std::string modName, std::vector<std::string> fileList, bool validate);
+		void preloadModData(std::string modName, JsonNode data);
 		bool loadMod(std::string modName, bool validate);
 		void loadCustom();
 		void afterLoadFinalization();
 	};
 
-	/// preloads all data from fileList as data from modName.
-	bool preloadModData(std::string modName, JsonNode modConfig, bool validate);
-
 	/// actually loads data in mod
 	bool loadMod(std::string modName, bool validate);
 
 	std::map<std::string, ContentTypeHandler> handlers;
 public:
 	/// fully initialize object. Will cause reading of H3 config files
-	CContentHandler();
+	/// templatesOnly - handle only random map templates, which are not stored in game database snapshot
+	CContentHandler(bool templatesOnly = false);
 
-	/// preloads all data from fileList as data from modName.
-	void preloadData(CModInfo & mod);
+	/// preloads data of all mods. Files of all mods are parsed in parallel
+	/// but data is added in order of mods, so patches from other mods are applied same way
+	void preloadData(const std::vector<CModInfo *> & mods);
 
 	/// actually loads data in mod
 	void load(CModInfo & mod);
@@ -262,8 +265,15 @@ public:
 	std::vector<std::string> getAllMods();
 	std::vector<std::string> getActiveMods();
 
+	/// calculates checksums of all active mods, must be called before load()
+	void calculateChecksums();
+	/// checksums of core and all active mods in load order, identify content which will be loaded
+	std::vector<std::pair<TModID, ui32>> getChecksums() const;
+
 	/// load content from all available mods
 	void load();
+	/// load content which is not stored in game database snapshot, rest of content is restored by LibClasses
+	void loadTemplates();
 	void afterLoad();
 
 	struct DLL_LINKAGE hardcodedFeatures
@@ -17,7 +17,9 @@
 #include "GameConstants.h"
 #include "CStopWatch.h"
 #include "CConfigHandler.h"
+#include "CThreadHelper.h"
 #include "../lib/CPlayerState.h"
+#include "NetPacks.h"
 
 CPathfinder::PathfinderOptions::PathfinderOptions()
 {
@@ -36,6 +38,21 @@ CPathfinder::PathfinderOptions::PathfinderOptions()
 	originalMovementRules = settings["pathfinder"]["originalMovementRules"].Bool();
 }
 
+ui32 CPathfinder::PathfinderOptions::getFlags() const
+{
+	const bool flags[] = {
+		useFlying, useWaterWalking, useEmbarkAndDisembark,
+		useTeleportTwoWay, useTeleportOneWay, useTeleportOneWayRandom, useTeleportWhirlpool, useCastleGate,
+		lightweightFlyingMode, oneTurnSpecialLayersLimit, originalMovementRules
+	};
+
+	ui32 ret = 0;
+	for(int i = 0; i < ARRAY_COUNT(flags); i++)
+		ret |= flags[i] << i;
+
+	return ret;
+}
+
 CPathfinder::CPathfinder(CPathsInfo & _out, CGameState * _gs, const CGHeroInstance * _hero)
 	: CGameInfoCallback(_gs, boost::optional<PlayerColor>()), out(_out), hero(_hero), FoW(getPlayerTeam(hero->tempOwner)->fogOfWarMap), patrolTiles({})
 {
@@ -58,12 +75,138 @@ CPathfinder::CPathfinder(CPathsInfo & _out, CGameState * _gs, const CGHeroInstan
 	hlp = make_unique<CPathfinderHelper>(hero, options);
 
 	initializePatrol();
-	initializeGraph();
 	neighbourTiles.reserve(8);
 	neighbours.reserve(16);
 }
 
 void CPathfinder::calculatePaths()
+{
+	out.graphValid = false;
+	updatePaths();
+}
+
+void CPathfinder::updatePaths()
+{
+	const auto inputs = getSearchInputs();
+	bool searchValid = out.searchValid && out.searchInputs == inputs;
+
+	if(out.graphValid && out.graphOwner == hero->tempOwner && out.graphOptions == options.getFlags())
+	{
+		/// Guards are found by looking at neighbouring tiles, so change of tile also affects its neighbours
+		std::vector<int3> tiles;
+		for(auto & changed : out.changedTiles)
+		{
+			for(int3 pos = changed - int3(1, 1, 0); pos.x <= changed.x + 1; pos.x++)
+			{
+				for(pos.y = changed.y - 1; pos.y <= changed.y + 1; pos.y++)
+				{
+					if(isInTheMap(pos))
+						tiles.push_back(pos);
+				}
+			}
+		}
+		boost::sort(tiles);
+		tiles.erase(boost::unique(tiles).end(), tiles.end());
+
+		if(searchValid && isSearchAffected(tiles))
+			searchValid = false;
+		if(!searchValid)
+			resetSearch();
+
+		for(auto & tile : tiles)
+			initializeTile(tile);
+	}
+	else
+	{
+		searchValid = false;
+		resetSearch();
+		initializeGraph();
+		out.graphValid = true;
+		out.graphOwner = hero->tempOwner;
+		out.graphOptions = options.getFlags();
+	}
+	out.changedTiles.clear();
+
+	if(!searchValid)
+	{
+		out.searchInputs = inputs;
+		search();
+		/// Patrol area isn't part of inputs, such searches are never reused
+		out.searchValid = patrolState == PATROL_NONE;
+	}
+}
+
+void CPathfinder::updatePaths(CGameState * gs, const std::vector<std::pair<const CGHeroInstance *, CPathsInfo *>> & heroes)
+{
+	/// Pathfinder constructor reads settings and creates bonus caches of hero, so only searches are done by worker threads
+	std::vector<std::unique_ptr<CPathfinder>> pathfinders;
+	for(auto & hero : heroes)
+	{
+		assert(boost::count_if(heroes, [&](const std::pair<const CGHeroInstance *, CPathsInfo *> & other){ return other.second == hero.second; }) == 1);
+
+		pathfinders.push_back(make_unique<CPathfinder>(*hero.second, gs, hero.first));
+	}
+
+	CThreadPool::get().parallelFor("pathfinder", 0, pathfinders.size(), [&](size_t i)
+	{
+		pathfinders[i]->updatePaths();
+	});
+}
+
+bool CPathfinder::isSearchAffected(const std::vector<int3> & tiles) const
+{
+	if(out.searchUsedTeleports && !tiles.empty())
+		return true;
+
+	for(auto & tile : tiles)
+	{
+		if(out.searchTiles[out.getTileIndex(tile)])
+			return true;
+	}
+
+	return false;
+}
+
+void CPathfinder::resetSearch()
+{
+	for(auto index : out.searchNodes)
+	{
+		auto & node = out.nodes[index];
+		auto accessible = node.accessible;
+		node.reset();
+		node.accessible = accessible;
+	}
+	out.searchNodes.clear();
+	out.searchTiles.assign(out.searchTiles.size(), false);
+	out.searchUsedTeleports = false;
+	out.searchValid = false;
+}
+
+CPathsInfo::SearchInputs CPathfinder::getSearchInputs() const
+{
+	CPathsInfo::SearchInputs inputs;
+	inputs.hero = hero;
+	inputs.pos = out.hpos;
+	inputs.movement = hero->movement;
+	inputs.boat = hero->boat;
+	inputs.maxMovePointsLand = hero->maxMovePoints(true);
+	inputs.maxMovePointsWater = hero->maxMovePoints(false);
+	inputs.bonusesVersion = hero->getTreeVersion();
+	inputs.day = gs->day;
+	return inputs;
+}
+
+void CPathfinder::markTileRead(const int3 & tile)
+{
+	out.searchTiles[out.getTileIndex(tile)] = true;
+}
+
+void CPathfinder::markNodeChanged(CGPathNode * node)
+{
+	out.searchNodes.push_back(out.getNodeIndex(node));
+}
+
+void CPathfinder::search()
 {
 	auto passOneTurnLimitCheck = [&]() -> bool
 	{
@@ -101,15 +244,20 @@ void CPathfinder::calculatePaths()
 	CGPathNode * initialNode = out.getNode(out.hpos, hero->boat ? ELayer::SAIL : ELayer::LAND);
 	initialNode->turns = 0;
 	initialNode->moveRemains = hero->movement;
+	markNodeChanged(initialNode);
 	if(isHeroPatrolLocked())
 		return;
 
-	pq.push(initialNode);
+	pq.push(out.getNodeIndex(initialNode), initialNode->turns, initialNode->moveRemains);
 	while(!pq.empty())
 	{
-		cp = pq.top();
-		pq.pop();
+		const ui32 cpIndex = pq.pop();
+		cp = &out.nodes[cpIndex];
+		if(cp->locked)
+			continue; //node was queued again with better cost and processed already
+
 		cp->locked = true;
+		markTileRead(cp->coord);
 
 		int movement = cp->moveRemains, turn = cp->turns;
 		hlp->updateTurnInfo(turn);
@@ -125,6 +273,9 @@ void CPathfinder::calculatePaths()
 
 		//add accessible neighbouring nodes to the queue
 		addNeighbours();
+		for(auto & tile : neighbourTiles)
+			markTileRead(tile);
+
 		for(auto & neighbour : neighbours)
 		{
 			if(!isPatrolMovementAllowed(neighbour))
@@ -178,14 +329,15 @@ void CPathfinder::calculatePaths()
 				if(isBetterWay(remains, turnAtNextTile) &&
 					((cp->turns == turnAtNextTile && remains) || passOneTurnLimitCheck()))
 				{
-					assert(dp != cp->theNodeBefore); //two tiles can't point to each other
+					assert(out.getNodeIndex(dp) != cp->theNodeBefore); //two tiles can't point to each other
 					dp->moveRemains = remains;
 					dp->turns = turnAtNextTile;
-					dp->theNodeBefore = cp;
+					dp->theNodeBefore = cpIndex;
 					dp->action = destAction;
+					markNodeChanged(dp);
 
 					if(isMovementAfterDestPossible())
-						pq.push(dp);
+						pq.push(out.getNodeIndex(dp), dp->turns, dp->moveRemains);
 				}
 			}
 		} //neighbours loop
@@ -194,6 +346,7 @@ void CPathfinder::calculatePaths()
 		addTeleportExits();
 		for(auto & neighbour : neighbours)
 		{
+			markTileRead(neighbour);
 			dp = out.getNode(neighbour, cp->layer);
 			if(dp->locked)
 				continue;
@@ -211,15 +364,64 @@ void CPathfinder::calculatePaths()
 
 				dp->moveRemains = movement;
 				dp->turns = turn;
-				dp->theNodeBefore = cp;
+				dp->theNodeBefore = cpIndex;
 				dp->action = getTeleportDestAction();
+				markNodeChanged(dp);
 				if(dp->action == CGPathNode::TELEPORT_NORMAL)
-					pq.push(dp);
+					pq.push(out.getNodeIndex(dp), dp->turns, dp->moveRemains);
 			}
 		}
 	} //queue loop
 }
 
+CPathfinder::NodeQueue::NodeQueue()
+	: turns(0), moveRemains(0), count(0)
+{
+}
+
+void CPathfinder::NodeQueue::push(const ui32 node, const ui8 Turns, const ui32 MoveRemains)
+{
+	if(buckets.size() <= Turns)
+		buckets.resize(Turns + 1);
+	if(buckets[Turns].size() <= MoveRemains)
+		buckets[Turns].resize(MoveRemains + 1);
+
+	buckets[Turns][MoveRemains].push_back(node);
+	if(!count || Turns < turns || (Turns == turns && MoveRemains > moveRemains))
+	{
+		turns = Turns;
+		moveRemains = MoveRemains;
+	}
+	count++;
+}
+
+ui32 CPathfinder::NodeQueue::pop()
+{
+	assert(!empty());
+	while(true)
+	{
+		auto & turnBuckets = buckets[turns];
+		for(vstd::amin(moveRemains, (int)turnBuckets.size() - 1); moveRemains >= 0; moveRemains--)
+		{
+			auto & bucket = turnBuckets[moveRemains];
+			if(!bucket.empty())
+			{
+				const ui32 node = bucket.back();
+				bucket.pop_back();
+				count--;
+				return node;
+			}
+		}
+		turns++;
+		moveRemains = buckets[turns].size() - 1;
+	}
+}
+
+bool CPathfinder::NodeQueue::empty() const
+{
+	return !count;
+}
+
 void CPathfinder::addNeighbours()
 {
 	neighbours.clear();
@@ -269,6 +471,7 @@ void CPathfinder::addTeleportExits()
 		&& (ctObj->ID == Obj::TOWN && ctObj->subID == ETownType::INFERNO
 		&& getPlayerRelations(hero->tempOwner, ctObj->tempOwner) != PlayerRelations::ENEMIES))
 	{
+		out.searchUsedTeleports = true;
 		/// TODO: Find way to reuse CPlayerSpecificInfoCallback::getTownsInfo
 		/// This may be handy if we allow to use teleportation to friendly towns
 		auto towns = getPlayer(hero->tempOwner)->towns;
@@ -673,48 +876,51 @@ void CPathfinder::initializePatrol()
 
 void CPathfinder::initializeGraph()
 {
-	auto updateNode = [&](int3 pos, ELayer layer, const TerrainTile * tinfo)
-	{
-		auto node = out.getNode(pos, layer);
-		auto accessibility = evaluateAccessibility(pos, tinfo, layer);
-		node->update(pos, layer, accessibility);
-	};
-
 	int3 pos;
 	for(pos.x=0; pos.x < out.sizes.x; ++pos.x)
 	{
 		for(pos.y=0; pos.y < out.sizes.y; ++pos.y)
 		{
 			for(pos.z=0; pos.z < out.sizes.z; ++pos.z)
-			{
-				const TerrainTile * tinfo = &gs->map->getTile(pos);
-				switch(tinfo->terType)
-				{
-				case ETerrainType::ROCK:
-					break;
-
-				case ETerrainType::WATER:
-					updateNode(pos, ELayer::SAIL, tinfo);
-					if(options.useFlying)
-						updateNode(pos, ELayer::AIR, tinfo);
-					if(options.useWaterWalking)
-						updateNode(pos, ELayer::WATER, tinfo);
-					break;
-
-				default:
-					updateNode(pos, ELayer::LAND, tinfo);
-					if(options.useFlying)
-						updateNode(pos, ELayer::AIR, tinfo);
-					break;
-				}
-			}
+				initializeTile(pos);
 		}
 	}
 }
 
+void CPathfinder::initializeTile(const int3 & pos)
+{
+	auto updateNode = [&](ELayer layer, const TerrainTile * tinfo)
+	{
+		auto node = out.getNode(pos, layer);
+		auto accessibility = evaluateAccessibility(pos, tinfo, layer);
+		node->update(pos, layer, accessibility);
+	};
+
+	const TerrainTile * tinfo = &gs->map->getTile(pos);
+	switch(tinfo->terType)
+	{
+	case ETerrainType::ROCK:
+		break;
+
+	case ETerrainType::WATER:
+		updateNode(ELayer::SAIL, tinfo);
+		if(options.useFlying)
+			updateNode(ELayer::AIR, tinfo);
+		if(options.useWaterWalking)
+			updateNode(ELayer::WATER, tinfo);
+		break;
+
+	default:
+		updateNode(ELayer::LAND, tinfo);
+		if(options.useFlying)
+			updateNode(ELayer::AIR, tinfo);
+		break;
+	}
+}
+
 CGPathNode::EAccessibility CPathfinder::evaluateAccessibility(const int3 & pos, const TerrainTile * tinfo, const ELayer layer) const
 {
-	if(tinfo->terType == ETerrainType::ROCK || !FoW[pos.x][pos.y][pos.z])
+	if(tinfo->terType == ETerrainType::ROCK || !FoW.isVisible(pos))
 		return CGPathNode::BLOCKED;
 
 	switch(layer)
@@ -793,7 +999,11 @@ bool CPathfinder::canMoveBetween(const int3 & a, const int3 & b) const
 
 bool CPathfinder::isAllowedTeleportEntrance(const CGTeleport * obj) const
 {
-	if(!obj || !isTeleportEntrancePassable(obj, hero->tempOwner))
+	if(!obj)
+		return false;
+
+	out.searchUsedTeleports = true;
+	if(!isTeleportEntrancePassable(obj, hero->tempOwner))
 		return false;
 
 	auto whirlpool = dynamic_cast<const CGWhirlpool *>(obj);
@@ -854,6 +1064,12 @@ TurnInfo::BonusCache::BonusCache(TBonusListPtr bl)
 	flyingMovementVal = bl->valOfBonuses(Selector::type(Bonus::FLYING_MOVEMENT));
 	waterWalking = static_cast<bool>(bl->getFirst(Selector::type(Bonus::WATER_WALKING)));
 	waterWalkingVal = bl->valOfBonuses(Selector::type(Bonus::WATER_WALKING));
+	movementVal = bl->valOfBonuses(Selector::type(Bonus::MOVEMENT).And(Selector::subtype(-1)));
+	landMovementVal = bl->valOfBonuses(Selector::type(Bonus::LAND_MOVEMENT).And(Selector::subtype(-1)));
+	seaMovementVal = bl->valOfBonuses(Selector::type(Bonus::SEA_MOVEMENT).And(Selector::subtype(-1)));
+	pathfindingVal = bl->valOfBonuses(Selector::type(Bonus::SECONDARY_SKILL_PREMY).And(Selector::subtype(SecondarySkill::PATHFINDING)));
+	logisticsVal = bl->valOfBonuses(Selector::type(Bonus::SECONDARY_SKILL_PREMY).And(Selector::subtype(SecondarySkill::LOGISTICS)));
+	navigationVal = bl->valOfBonuses(Selector::type(Bonus::SECONDARY_SKILL_PREMY).And(Selector::subtype(SecondarySkill::NAVIGATION)));
 }
 
 TurnInfo::TurnInfo(const CGHeroInstance * Hero, const int turn)
@@ -865,6 +1081,59 @@ TurnInfo::TurnInfo(const CGHeroInstance * Hero, const int turn)
 	bonuses = hero->getAllBonuses(Selector::days(turn), nullptr, nullptr, cachingStr.str());
 	bonusCache = make_unique<BonusCache>(bonuses);
 	nativeTerrain = hero->getNativeTerrain();
+	initTileCosts();
+}
+
+void TurnInfo::initTileCosts()
+{
+	static const int roadCosts[] = {75, 65, 50, GameConstants::BASE_MOVEMENT_COST}; //dirt, gravel, cobblestone and unknown road
+
+	for(int i = 0; i < ARRAY_COUNT(tileCosts); i++)
+	{
+		int cost = GameConstants::BASE_MOVEMENT_COST;
+		if(i >= GameConstants::TERRAIN_TYPES)
+			cost = roadCosts[i - GameConstants::TERRAIN_TYPES];
+		else if(nativeTerrain != i && (i == ETerrainType::ROCK || !hasBonusOfType(Bonus::NO_TERRAIN_PENALTY, i)))
+			cost = std::max<int>(GameConstants::BASE_MOVEMENT_COST, VLC->heroh->terrCosts[i] - bonusCache->pathfindingVal);
+
+		for(int movement = NORMAL_MOVEMENT; movement < MOVEMENT_TYPES; movement++)
+		{
+			int ret = cost;
+			switch(movement)
+			{
+			case FLYING_MOVEMENT:
+				ret *= (100.0 + bonusCache->flyingMovementVal) / 100.0;
+				break;
+			case WATER_WALKING_MOVEMENT:
+				ret *= (100.0 + bonusCache->waterWalkingVal) / 100.0;
+				break;
+			case FAVORABLE_WINDS_MOVEMENT:
+				ret *= 0.666;
+				break;
+			}
+
+			tileCosts[i][movement][0] = ret;
+			ret *= 1.414213;
+			tileCosts[i][movement][1] = ret;
+		}
+	}
+}
+
+int TurnInfo::getTileCost(const TerrainTile & dest, const TerrainTile & from, const EMovementType movement, const bool diagonal) const
+{
+	//if there is road both on dest and src tiles - use road movement cost
+	if(dest.roadType != ERoadType::NO_ROAD && from.roadType != ERoadType::NO_ROAD)
+	{
+		int road = std::min(dest.roadType, from.roadType); //used road ID
+		if(road < ERoadType::DIRT_ROAD || road > ERoadType::COBBLESTONE_ROAD)
+		{
+			logGlobal->error("Unknown road type: %d", road);
+			road = ERoadType::COBBLESTONE_ROAD + 1;
+		}
+		return tileCosts[GameConstants::TERRAIN_TYPES - 1 + road][movement][diagonal];
+	}
+
+	return tileCosts[from.terType][movement][diagonal];
 }
 
 bool TurnInfo::isLayerAvailable(const EPathfindingLayer layer) const
@@ -913,6 +1182,29 @@ int TurnInfo::valOfBonuses(Bonus::BonusType type, int subtype) const
 		return bonusCache->flyingMovementVal;
 	case Bonus::WATER_WALKING:
 		return bonusCache->waterWalkingVal;
+	case Bonus::MOVEMENT:
+		if(subtype == -1)
+			return bonusCache->movementVal;
+		break;
+	case Bonus::LAND_MOVEMENT:
+		if(subtype == -1)
+			return bonusCache->landMovementVal;
+		break;
+	case Bonus::SEA_MOVEMENT:
+		if(subtype == -1)
+			return bonusCache->seaMovementVal;
+		break;
+	case Bonus::SECONDARY_SKILL_PREMY:
+		switch(subtype)
+		{
+		case SecondarySkill::PATHFINDING:
+			return bonusCache->pathfindingVal;
+		case SecondarySkill::LOGISTICS:
+			return bonusCache->logisticsVal;
+		case SecondarySkill::NAVIGATION:
+			return bonusCache->navigationVal;
+		}
+		break;
 	}
 
 	return bonuses->valOfBonuses(Selector::type(type).And(Selector::subtype(subtype)));
@@ -1053,29 +1345,27 @@ int CPathfinderHelper::getMovementCost(const CGHeroInstance * h, const int3 & sr
 	/// TODO: by the original game rules hero shouldn't be affected by terrain penalty while flying.
 	/// Also flying movement only has penalty when player moving over blocked tiles.
 	/// So if you only have base flying with 40% penalty you can still ignore terrain penalty while having zero flying penalty.
-	int ret = h->getTileCost(*dt, *ct, ti);
 	/// Unfortunately this can't be implemented yet as server don't know when player flying and when he's not.
 	/// Difference in cost calculation on client and server is much worse than incorrect cost.
 	/// So this one is waiting till server going to use pathfinder rules for path validation.
-
+	TurnInfo::EMovementType movement = TurnInfo::NORMAL_MOVEMENT;
 	if(dt->blocked && ti->hasBonusOfType(Bonus::FLYING_MOVEMENT))
 	{
-		ret *= (100.0 + ti->valOfBonuses(Bonus::FLYING_MOVEMENT)) / 100.0;
+		movement = TurnInfo::FLYING_MOVEMENT;
 	}
 	else if(dt->terType == ETerrainType::WATER)
 	{
 		if(h->boat && ct->hasFavorableWinds() && dt->hasFavorableWinds())
-			ret *= 0.666;
+			movement = TurnInfo::FAVORABLE_WINDS_MOVEMENT;
 		else if(!h->boat && ti->hasBonusOfType(Bonus::WATER_WALKING))
-		{
-			ret *= (100.0 + ti->valOfBonuses(Bonus::WATER_WALKING)) / 100.0;
-		}
+			movement = TurnInfo::WATER_WALKING_MOVEMENT;
 	}
 
+	int ret = ti->getTileCost(*dt, *ct, movement);
 	if(src.x != dst.x && src.y != dst.y) //it's diagonal move
 	{
 		int old = ret;
-		ret *= 1.414213;
+		ret = ti->getTileCost(*dt, *ct, movement, true);
 		//diagonal move costs too much but normal move is possible - allow diagonal move for remaining move points
 		if(ret > remainingMovePoints && remainingMovePoints >= old)
 		{
@@ -1093,10 +1383,11 @@ int CPathfinderHelper::getMovementCost(const CGHeroInstance * h, const int3 & sr
 	{
 		std::vector<int3> vec;
 		vec.reserve(8); //optimization
-		getNeighbours(h->cb->gameState()->map, *dt, dst, vec, ct->terType != ETerrainType::WATER, true);
+		const CMap * map = h->cb->gameState()->map;
+		getNeighbours(map, *dt, dst, vec, ct->terType != ETerrainType::WATER, true);
 		for(auto & elem : vec)
 		{
-			int fcost = getMovementCost(h, dst, elem, nullptr, nullptr, left, ti, false);
+			int fcost = getMovementCost(h, dst, elem, dt, &map->getTile(elem), left, ti, false);
 			if(fcost <= left)
 			{
 				if(localTi)
@@ -1131,7 +1422,7 @@ void CGPathNode::reset()
 	accessible = NOT_SET;
 	moveRemains = 0;
 	turns = 255;
-	theNodeBefore = nullptr;
+	theNodeBefore = NO_NODE;
 	action = UNKNOWN;
 }
 
@@ -1175,10 +1466,11 @@ void CGPath::convert(ui8 mode)
 }
 
 CPathsInfo::CPathsInfo(const int3 & Sizes)
-	: sizes(Sizes)
+	: sizes(Sizes), graphValid(false), graphOptions(0), searchValid(false), searchUsedTeleports(false)
 {
 	hero = nullptr;
-	nodes.resize(boost::extents[sizes.x][sizes.y][sizes.z][ELayer::NUM_LAYERS]);
+	nodes.resize(sizes.x * sizes.y * sizes.z * ELayer::NUM_LAYERS);
+	searchTiles.resize(sizes.x * sizes.y * sizes.z);
 }
 
 CPathsInfo::~CPathsInfo()
@@ -1201,14 +1493,16 @@ bool CPathsInfo::getPath(CGPath & out, const int3 & dst) const
 
 	out.nodes.clear();
 	const CGPathNode * curnode = getNode(dst);
-	if(!curnode->theNodeBefore)
+	if(curnode->theNodeBefore == CGPathNode::NO_NODE)
 		return false;
 
-	while(curnode)
+	while(true)
 	{
-		const CGPathNode cpn = * curnode;
-		curnode = curnode->theNodeBefore;
-		out.nodes.push_back(cpn);
+		out.nodes.push_back(*curnode);
+		if(curnode->theNodeBefore == CGPathNode::NO_NODE)
+			break;
+
+		curnode = &nodes[curnode->theNodeBefore];
 	}
 	return true;
 }
@@ -1226,14 +1520,63 @@ int CPathsInfo::getDistance(const int3 & tile) const
 
 const CGPathNode * CPathsInfo::getNode(const int3 & coord) const
 {
-	auto landNode = &nodes[coord.x][coord.y][coord.z][ELayer::LAND];
+	auto landNode = &nodes[getNodeIndex(coord, ELayer::LAND)];
 	if(landNode->reachable())
 		return landNode;
 	else
-		return &nodes[coord.x][coord.y][coord.z][ELayer::SAIL];
+		return &nodes[getNodeIndex(coord, ELayer::SAIL)];
 }
 
 CGPathNode * CPathsInfo::getNode(const int3 & coord, const ELayer layer)
 {
-	return &nodes[coord.x][coord.y][coord.z][layer];
+	return &nodes[getNodeIndex(coord, layer)];
+}
+
+void CPathsInfo::invalidate(const std::vector<int3> & changedTiles)
+{
+	hero = nullptr;
+	vstd::concatenate(this->changedTiles, changedTiles);
+}
+
+void CPathsInfo::invalidate(const CGObjectInstance * obj)
+{
+	std::vector<int3> tiles;
+	for(auto & tile : obj->getBlockedPos())
+		tiles.push_back(tile);
+	tiles.push_back(obj->visitablePos());
+
+	invalidate(tiles);
+}
+
+void CPathsInfo::invalidate(const CGObjectInstance * obj, ui8 property)
+{
+	if(property == ObjProperty::OWNER || property == ObjProperty::BLOCKVIS || property == ObjProperty::ID)
+		invalidate(obj);
+	else
+		invalidate();
+}
+
+void CPathsInfo::invalidate()
+{
+	hero = nullptr;
+	graphValid = false;
+	searchValid = false;
+	changedTiles.clear();
+}
+
+size_t CPathsInfo::getTileIndex(const int3 & tile) const
+{
+	return tile.x + sizes.x * (tile.y + sizes.y * tile.z);
+}
+
+bool CPathsInfo::SearchInputs::operator==(const SearchInputs & other) const
+{
+	return hero == other.hero
+		&& pos == other.pos
+		&& movement == other.movement
+		&& boat == other.boat
+		&& maxMovePointsLand == other.maxMovePointsLand
+		&& maxMovePointsWater == other.maxMovePointsWater
+		&& bonusesVersion == other.bonusesVersion
+		&& day == other.day;
 }
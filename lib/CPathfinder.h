@@ -14,14 +14,13 @@
 #include "HeroBonus.h"
 #include "int3.h"
 
-#include <boost/heap/priority_queue.hpp>
-
 class CGHeroInstance;
 class CGObjectInstance;
 struct TerrainTile;
 class CPathfinderHelper;
 class CMap;
 class CGWhirlpool;
+class CFogOfWarMap;
 
 struct DLL_LINKAGE CGPathNode
 {
@@ -51,8 +50,10 @@ struct DLL_LINKAGE CGPathNode
 		BLOCKED //tile can't be entered nor visited
 	};
 
-	CGPathNode * theNodeBefore;
+	static const ui32 NO_NODE = 0xffffffff;
+
 	int3 coord; //coordinates
+	ui32 theNodeBefore; //index of previous node of path in CPathsInfo::nodes, NO_NODE if there is none
 	ui32 moveRemains; //remaining tiles after hero reaches the tile
 	ui8 turns; //how many turns we have to wait before reachng the tile - 0 means current turn
 	ELayer layer;
@@ -81,10 +82,10 @@ struct DLL_LINKAGE CPathsInfo
 
 	mutable boost::mutex pathMx;
 
-	const CGHeroInstance * hero;
+	const CGHeroInstance * hero; //nullptr if paths are outdated
 	int3 hpos;
 	int3 sizes;
-	boost::multi_array<CGPathNode, 4> nodes; //[w][h][level][layer]
+	std::vector<CGPathNode> nodes; //[w][h][level][layer] stored in one block, see getNodeIndex
 
 	CPathsInfo(const int3 & Sizes);
 	~CPathsInfo();
@@ -94,6 +95,56 @@ struct DLL_LINKAGE CPathsInfo
 	const CGPathNode * getNode(const int3 & coord) const;
 
 	CGPathNode * getNode(const int3 & coord, const ELayer layer);
+
+	ui32 getNodeIndex(const int3 & coord, const ELayer layer) const
+	{
+		return ((coord.x * sizes.y + coord.y) * sizes.z + coord.z) * ELayer::NUM_LAYERS + layer;
+	}
+	ui32 getNodeIndex(const CGPathNode * node) const
+	{
+		return node - nodes.data();
+	}
+
+	/// Marks paths as outdated because objects or visibility of given tiles changed
+	/// Next incremental calculation only re-evaluates these tiles and reuses everything that doesn't depend on them
+	void invalidate(const std::vector<int3> & changedTiles);
+	void invalidate(const CGObjectInstance * obj); //tiles occupied by object
+	/// Only changes of owner, blocking and type are known to affect nothing but tiles of object itself
+	/// Other properties may change passability elsewhere (e.g. keymaster tent opens border gates), paths are recalculated
+	void invalidate(const CGObjectInstance * obj, ui8 property);
+	/// Marks paths as outdated, next calculation will start from scratch
+	void invalidate();
+
+private:
+	friend class CPathfinder;
+
+	/// Everything besides map tiles that result of path search depends on
+	struct SearchInputs
+	{
+		const CGHeroInstance * hero;
+		int3 pos;
+		ui32 movement;
+		const CGObjectInstance * boat;
+		int maxMovePointsLand;
+		int maxMovePointsWater;
+		int64_t bonusesVersion;
+		int day;
+
+		bool operator==(const SearchInputs & other) const;
+	};
+
+	bool graphValid; //accessibility of nodes is up to date except for changedTiles
+	PlayerColor graphOwner;
+	ui32 graphOptions;
+	std::vector<int3> changedTiles;
+
+	bool searchValid;
+	SearchInputs searchInputs;
+	bool searchUsedTeleports; //teleport exits may be anywhere on map so any change may affect such search
+	std::vector<ui32> searchNodes; //nodes modified by last search
+	std::vector<bool> searchTiles; //tiles read by last search, indexed by getTileIndex
+
+	size_t getTileIndex(const int3 & tile) const;
 };
 
 class CPathfinder : private CGameInfoCallback
@@ -103,6 +154,11 @@ public:
 
 	CPathfinder(CPathsInfo & _out, CGameState * _gs, const CGHeroInstance * _hero);
 	void calculatePaths(); //calculates possible paths for hero, uses current hero position and movement left; returns pointer to newly allocated CPath or nullptr if path does not exists
+	void updatePaths(); //same as calculatePaths but reuses results of previous calculation that weren't affected by changes reported via CPathsInfo::invalidate
+
+	/// Updates paths of several heroes at once, each one in its own CPathsInfo
+	/// Map and fog of war are only read during search so searches of different heroes run in parallel
+	static void updatePaths(CGameState * gs, const std::vector<std::pair<const CGHeroInstance *, CPathsInfo *>> & heroes);
 
 private:
 	typedef EPathfindingLayer ELayer;
@@ -156,11 +212,12 @@ private:
 		bool originalMovementRules;
 
 		PathfinderOptions();
+		ui32 getFlags() const; //all options packed into bitmask, used to detect changes of settings
 	} options;
 
 	CPathsInfo & out;
 	const CGHeroInstance * hero;
-	const std::vector<std::vector<std::vector<ui8> > > &FoW;
+	const CFogOfWarMap & FoW;
 	std::unique_ptr<CPathfinderHelper> hlp;
 
 	enum EPatrolState {
@@ -170,19 +227,22 @@ private:
 	} patrolState;
 	std::unordered_set<int3, ShashInt3> patrolTiles;
 
-	struct NodeComparer
+	/// Open list of search: nodes with fewer turns go first, then ones with more movement points left
+	/// Both keys are small integers, so instead of heap nodes are put into bucket for each pair of them.
+	/// Search never adds node that goes before last taken one, so buckets are scanned only once.
+	class NodeQueue
 	{
-		bool operator()(const CGPathNode * lhs, const CGPathNode * rhs) const
-		{
-			if(rhs->turns > lhs->turns)
-				return false;
-			else if(rhs->turns == lhs->turns && rhs->moveRemains <= lhs->moveRemains)
-				return false;
-
-			return true;
-		}
-	};
-	boost::heap::priority_queue<CGPathNode *, boost::heap::compare<NodeComparer> > pq;
+	public:
+		NodeQueue();
+		void push(const ui32 node, const ui8 turns, const ui32 moveRemains);
+		ui32 pop();
+		bool empty() const;
+
+	private:
+		std::vector<std::vector<std::vector<ui32> > > buckets; //[turns][moveRemains]
+		int turns, moveRemains; //first bucket that may be not empty
+		size_t count;
+	} pq;
 
 	std::vector<int3> neighbourTiles;
 	std::vector<int3> neighbours;
@@ -215,6 +275,14 @@ private:
 
 	void initializePatrol();
 	void initializeGraph();
+	void initializeTile(const int3 & pos);
+	bool isSearchAffected(const std::vector<int3> & tiles) const;
+	void resetSearch();
+	void search();
+	CPathsInfo::SearchInputs getSearchInputs() const;
+
+	void markTileRead(const int3 & tile);
+	void markNodeChanged(CGPathNode * node);
 
 	CGPathNode::EAccessibility evaluateAccessibility(const int3 & pos, const TerrainTile * tinfo, const ELayer layer) const;
 	bool isVisitableObj(const CGObjectInstance * obj, const ELayer layer) const;
@@ -240,11 +308,27 @@ struct DLL_LINKAGE TurnInfo
 		int flyingMovementVal;
 		bool waterWalking;
 		int waterWalkingVal;
+		int movementVal;
+		int landMovementVal;
+		int seaMovementVal;
+		int pathfindingVal;
+		int logisticsVal;
+		int navigationVal;
 
 		BonusCache(TBonusListPtr bonusList);
 	};
 	std::unique_ptr<BonusCache> bonusCache;
 
+	/// Modifiers of tile cost that depend on way of movement, see CPathfinderHelper::getMovementCost
+	enum EMovementType : ui8
+	{
+		NORMAL_MOVEMENT = 0,
+		FLYING_MOVEMENT, //over blocked tile
+		WATER_WALKING_MOVEMENT,
+		FAVORABLE_WINDS_MOVEMENT,
+		MOVEMENT_TYPES
+	};
+
 	const CGHeroInstance * hero;
 	TBonusListPtr bonuses;
 	mutable int maxMovePointsLand;
@@ -256,6 +340,14 @@ struct DLL_LINKAGE TurnInfo
 	bool hasBonusOfType(const Bonus::BonusType type, const int subtype = -1) const;
 	int valOfBonuses(const Bonus::BonusType type, const int subtype = -1) const;
 	int getMaxMovePoints(const EPathfindingLayer layer) const;
+	int getTileCost(const TerrainTile & dest, const TerrainTile & from, const EMovementType movement = NORMAL_MOVEMENT, const bool diagonal = false) const;
+
+private:
+	/// Costs of all moves are computed when turn info is created, since pathfinder asks for them hundreds of thousands times
+	/// First index is terrain of source tile, or road type if both tiles have road, last row is for unknown roads
+	int tileCosts[GameConstants::TERRAIN_TYPES + ERoadType::COBBLESTONE_ROAD + 1][MOVEMENT_TYPES][2];
+
+	void initTileCosts();
 };
 
 class DLL_LINKAGE CPathfinderHelper
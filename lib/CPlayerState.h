@@ -10,6 +10,7 @@
 #pragma once
 
 #include "HeroBonus.h"
+#include "CFogOfWarMap.h"
 
 class CGHeroInstance;
 class CGTownInstance;
@@ -72,8 +73,7 @@ struct DLL_LINKAGE TeamState : public CBonusSystemNode
 public:
 	TeamID id; //position in gameState::teams
 	std::set<PlayerColor> players; // members of this team
-	//TODO: boost::array, bool if possible
-	std::vector<std::vector<std::vector<ui8> > >  fogOfWarMap; //true - visible, false - hidden
+	CFogOfWarMap fogOfWarMap;
 
 	TeamState();
 	TeamState(TeamState && other);
@@ -82,7 +82,20 @@ public:
 	{
 		h & id;
 		h & players;
-		h & fogOfWarMap;
+		if(version >= 779)
+		{
+			h & fogOfWarMap;
+		}
+		else if(!h.saving)
+		{
+			std::vector<std::vector<std::vector<ui8> > > oldFogOfWarMap;
+			h & oldFogOfWarMap;
+			fogOfWarMap.resize(int3(oldFogOfWarMap.size(), oldFogOfWarMap.at(0).size(), oldFogOfWarMap.at(0).at(0).size()));
+			for(int x = 0; x < oldFogOfWarMap.size(); x++)
+				for(int y = 0; y < oldFogOfWarMap[x].size(); y++)
+					for(int z = 0; z < oldFogOfWarMap[x][y].size(); z++)
+						fogOfWarMap.setVisible(int3(x, y, z), oldFogOfWarMap[x][y][z]);
+		}
 		h & static_cast<CBonusSystemNode&>(*this);
 	}
 
@@ -10,43 +10,342 @@
 #include "StdInc.h"
 #include "CThreadHelper.h"
 
+#include <chrono>
+
 #ifdef VCMI_WINDOWS
 	#include <windows.h>
 #elif !defined(VCMI_APPLE) && !defined(VCMI_FREEBSD) && !defined(VCMI_HURD)
 	#include <sys/prctl.h>
 #endif
 
-CThreadHelper::CThreadHelper(std::vector<std::function<void()> > *Tasks, int Threads)
+static void runTask(const Task & task)
+{
+	try
+	{
+		task();
+	}
+	catch(...)
+	{
+		handleException();
+	}
+}
+
+CThreadPool::CThreadPool(size_t threadsCount)
+	: queued(0), stopping(false)
+{
+	assert(threadsCount > 0);
+
+	for(size_t i = 0; i < threadsCount; i++)
+	{
+		workers.push_back(make_unique<Worker>());
+		workers.back()->pool = this;
+		workers.back()->index = i;
+	}
+	for(auto & worker : workers)
+		threads.push_back(boost::thread(&CThreadPool::workerLoop, this, worker.get()));
+}
+
+CThreadPool::~CThreadPool()
+{
+	{
+		boost::unique_lock<boost::mutex> lock(sleepMx);
+		stopping = true;
+	}
+	wakeup.notify_all();
+
+	for(auto & thread : threads)
+		thread.join();
+}
+
+CThreadPool & CThreadPool::get()
+{
+	// never destroyed - workers may still sleep while static objects are torn down
+	static CThreadPool * pool = new CThreadPool(std::max((ui32)1, boost::thread::hardware_concurrency()));
+	return *pool;
+}
+
+size_t CThreadPool::size() const
+{
+	return workers.size();
+}
+
+boost::thread_specific_ptr<CThreadPool::Worker> & CThreadPool::threadWorker()
+{
+	// workers are owned by their pools
+	static boost::thread_specific_ptr<Worker> worker([](Worker *){});
+	return worker;
+}
+
+CThreadPool::Worker * CThreadPool::currentWorker() const
+{
+	Worker * worker = threadWorker().get();
+	if(worker && worker->pool == this)
+		return worker;
+	return nullptr;
+}
+
+void CThreadPool::submit(Task task)
 {
-	currentTask = 0; amount = Tasks->size();
-	tasks = Tasks;
-	threads = Threads;
+	// counter goes first so it is never lower than number of queued tasks
+	queued++;
+
+	if(Worker * worker = currentWorker())
+	{
+		boost::unique_lock<boost::mutex> lock(worker->mx);
+		worker->queue.push_back(std::move(task));
+	}
+	else
+	{
+		boost::unique_lock<boost::mutex> lock(externalMx);
+		externalQueue.push_back(std::move(task));
+	}
+
+	{
+		// worker may be between checking the counter and going to sleep
+		boost::unique_lock<boost::mutex> lock(sleepMx);
+	}
+	wakeup.notify_one();
 }
-void CThreadHelper::run()
+
+bool CThreadPool::popTask(Task & task)
 {
-	boost::thread_group grupa;
-	std::vector<boost::thread *> thr;
-	for(int i=0;i<threads;i++)
-		thr.push_back(grupa.create_thread(std::bind(&CThreadHelper::processTasks,this)));
-	grupa.join_all();
+	Worker * self = currentWorker();
+
+	// own tasks are taken from back, they are most likely to be hot in cache
+	if(self)
+	{
+		boost::unique_lock<boost::mutex> lock(self->mx);
+		if(!self->queue.empty())
+		{
+			task = std::move(self->queue.back());
+			self->queue.pop_back();
+			queued--;
+			return true;
+		}
+	}
+
+	{
+		boost::unique_lock<boost::mutex> lock(externalMx);
+		if(!externalQueue.empty())
+		{
+			task = std::move(externalQueue.front());
+			externalQueue.pop_front();
+			queued--;
+			return true;
+		}
+	}
+
+	// steal oldest task of other worker, starting with next one to spread thieves
+	const size_t first = self ? self->index + 1 : 0;
+	for(size_t i = 0; i < workers.size(); i++)
+	{
+		Worker * victim = workers[(first + i) % workers.size()].get();
+		if(victim == self)
+			continue;
 
-	for(auto thread : thr)
-		delete thread;
+		boost::unique_lock<boost::mutex> lock(victim->mx);
+		if(!victim->queue.empty())
+		{
+			task = std::move(victim->queue.front());
+			victim->queue.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
 }
-void CThreadHelper::processTasks()
+
+void CThreadPool::workerLoop(Worker * worker)
 {
+	threadWorker().reset(worker);
+	setThreadName("VCMI worker " + boost::lexical_cast<std::string>(worker->index));
+
 	while(true)
 	{
-		int pom;
+		Task task;
+		if(popTask(task))
 		{
-			boost::unique_lock<boost::mutex> lock(rtinm);
-			if((pom = currentTask) >= amount)
+			runTask(task);
+			continue;
+		}
+
+		boost::unique_lock<boost::mutex> lock(sleepMx);
+		while(!stopping && queued == 0)
+			wakeup.wait(lock);
+		if(stopping)
+			break;
+	}
+	threadWorker().release();
+}
+
+bool CThreadPool::runPendingTask()
+{
+	Task task;
+	if(!popTask(task))
+		return false;
+	runTask(task);
+	return true;
+}
+
+void CThreadPool::parallelFor(const std::string & name, size_t begin, size_t end, const std::function<void(size_t)> & body, size_t grain)
+{
+	if(begin >= end)
+		return;
+
+	grain = std::max<size_t>(grain, 1);
+	const size_t chunks = (end - begin + grain - 1) / grain;
+	std::atomic<size_t> nextChunk(0);
+
+	auto processChunks = [&]()
+	{
+		size_t chunk;
+		while((chunk = nextChunk++) < chunks)
+		{
+			const size_t chunkBegin = begin + chunk * grain;
+			const size_t chunkEnd = std::min(end, chunkBegin + grain);
+			try
+			{
+				for(size_t i = chunkBegin; i < chunkEnd; i++)
+					body(i);
+			}
+			catch(...)
+			{
+				// remaining chunks are skipped, group will rethrow
+				nextChunk = chunks;
+				throw;
+			}
+		}
+	};
+
+	CTaskGroup group(name, *this);
+	// calling thread processes chunks as well
+	const size_t helpers = std::min(chunks, size() + 1) - 1;
+	for(size_t i = 0; i < helpers; i++)
+		group.run(processChunks);
+	group.runHere(processChunks);
+	group.wait();
+}
+
+void CThreadPool::addStats(const std::string & name, const TaskStats & taskStats)
+{
+	boost::unique_lock<boost::mutex> lock(statsMx);
+	TaskStats & entry = stats[name];
+	entry.tasks += taskStats.tasks;
+	entry.microseconds += taskStats.microseconds;
+}
+
+std::map<std::string, TaskStats> CThreadPool::getStats()
+{
+	boost::unique_lock<boost::mutex> lock(statsMx);
+	return stats;
+}
+
+void CThreadPool::resetStats()
+{
+	boost::unique_lock<boost::mutex> lock(statsMx);
+	stats.clear();
+}
+
+void CThreadPool::logStats(const std::string & phase)
+{
+	std::map<std::string, TaskStats> finished;
+	{
+		boost::unique_lock<boost::mutex> lock(statsMx);
+		std::swap(finished, stats);
+	}
+
+	// time in tasks is summed over all threads, compare it with wall time of phase to see how much was done in parallel
+	for(auto & entry : finished)
+		logGlobal->info("	%s, %s: %d tasks, %d ms in tasks on %d threads", phase, entry.first, entry.second.tasks, entry.second.microseconds / 1000, size() + 1);
+}
+
+CTaskGroup::CTaskGroup(const std::string & name, CThreadPool & pool)
+	: name(name), pool(pool), pending(0), tasksDone(0), microseconds(0)
+{
+}
+
+CTaskGroup::~CTaskGroup()
+{
+	try
+	{
+		wait();
+	}
+	catch(...)
+	{
+		logGlobal->error("Unhandled exception in task group %s", name);
+		handleException();
+	}
+}
+
+void CTaskGroup::execute(const Task & task)
+{
+	const auto start = std::chrono::steady_clock::now();
+	try
+	{
+		task();
+	}
+	catch(...)
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		if(!error)
+			error = std::current_exception();
+	}
+	tasksDone++;
+	microseconds += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void CTaskGroup::run(Task task)
+{
+	pending++;
+	pool.submit([this, task]()
+	{
+		execute(task);
+
+		// mutex is held while notifying so group can't be destroyed before this task is done with it
+		boost::unique_lock<boost::mutex> lock(mx);
+		if(--pending == 0)
+			finished.notify_all();
+	});
+}
+
+void CTaskGroup::runHere(const Task & task)
+{
+	execute(task);
+}
+
+void CTaskGroup::wait()
+{
+	while(true)
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			if(pending == 0)
 				break;
-			else
-				++currentTask;
 		}
-		(*tasks)[pom]();
+
+		// help with pending tasks instead of blocking worker, this also prevents deadlocks of nested groups
+		if(!pool.runPendingTask())
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			if(pending == 0)
+				break;
+			finished.timed_wait(lock, boost::posix_time::milliseconds(1));
+		}
+	}
+
+	TaskStats taskStats;
+	taskStats.tasks = tasksDone.exchange(0);
+	taskStats.microseconds = microseconds.exchange(0);
+	if(taskStats.tasks)
+		pool.addStats(name, taskStats);
+
+	std::exception_ptr taskError;
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		std::swap(taskError, error);
 	}
+	if(taskError)
+		std::rethrow_exception(taskError);
 }
 
 // set name for this thread.
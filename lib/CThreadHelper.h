@@ -9,21 +9,122 @@
  */
 #pragma once
 
+#include <deque>
+#include <future>
 
 typedef std::function<void()> Task;
 
-/// Can assign CPU work to other threads/cores
-class DLL_LINKAGE CThreadHelper
+/// Accumulated timings of tasks submitted under one name
+struct DLL_LINKAGE TaskStats
 {
-	boost::mutex rtinm;
-	int currentTask, amount, threads;
-	std::vector<Task> *tasks;
+	ui64 tasks;
+	ui64 microseconds; //total time spent in tasks, summed over all threads
 
+	TaskStats() : tasks(0), microseconds(0) {}
+};
+
+/// Persistent pool of worker threads sized from the hardware
+/// Each worker has its own queue: tasks submitted by a worker go to the back of its queue and are taken by it in LIFO order,
+/// idle workers steal from the front of other queues. Tasks submitted from other threads go into shared queue.
+class DLL_LINKAGE CThreadPool
+{
+	struct Worker
+	{
+		CThreadPool * pool;
+		size_t index;
+		boost::mutex mx;
+		std::deque<Task> queue;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<boost::thread> threads;
+
+	boost::mutex externalMx;
+	std::deque<Task> externalQueue;
+
+	std::atomic<int> queued; //tasks in all queues, workers sleep only if there are none
+	boost::mutex sleepMx;
+	boost::condition_variable wakeup;
+	bool stopping;
+
+	boost::mutex statsMx;
+	std::map<std::string, TaskStats> stats;
+
+	static boost::thread_specific_ptr<Worker> & threadWorker(); //worker running in calling thread, if any
+	Worker * currentWorker() const; //worker of this pool running in calling thread
+	bool popTask(Task & task);
+	void workerLoop(Worker * worker);
+
+public:
+	explicit CThreadPool(size_t threadsCount);
+	~CThreadPool();
+
+	/// Pool shared by whole engine, uses all hardware threads
+	static CThreadPool & get();
+
+	size_t size() const;
+
+	/// Queues task for execution, exceptions thrown by task are logged and discarded. Use CTaskGroup to wait for tasks.
+	void submit(Task task);
+
+	/// Queues function for execution, its result or exception can be retrieved from returned future
+	/// NOTE: blocking on future from inside of pool task may deadlock, use CTaskGroup::wait() which helps with pending tasks instead
+	template<typename Func>
+	auto async(Func func) -> std::future<decltype(func())>
+	{
+		typedef decltype(func()) Result;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::move(func));
+		auto result = task->get_future();
+		submit([task]()
+		{
+			(*task)();
+		});
+		return result;
+	}
+
+	/// Executes one queued task in calling thread, returns false if there were none
+	bool runPendingTask();
+
+	/// Calls body for each index in [begin, end), in chunks of grain indexes. Calling thread takes part in work.
+	/// Returns once all indexes are processed, first exception thrown by body is rethrown
+	void parallelFor(const std::string & name, size_t begin, size_t end, const std::function<void(size_t)> & body, size_t grain = 1);
+
+	/// Timing counters are gathered per name of task group
+	void addStats(const std::string & name, const TaskStats & taskStats);
+	std::map<std::string, TaskStats> getStats();
+	void resetStats();
+	/// Logs counters gathered since last reset and resets them, phase is name of finished loading phase
+	void logStats(const std::string & phase);
+};
+
+/// Set of tasks that can be awaited together. Destructor waits for all tasks.
+class DLL_LINKAGE CTaskGroup : public boost::noncopyable
+{
+	const std::string name;
+	CThreadPool & pool;
+
+	std::atomic<size_t> pending;
+	std::atomic<ui64> tasksDone;
+	std::atomic<ui64> microseconds;
+
+	boost::mutex mx;
+	boost::condition_variable finished;
+	std::exception_ptr error; //first exception thrown by any task
+
+	void execute(const Task & task);
 
-	void processTasks();
 public:
-	CThreadHelper(std::vector<std::function<void()> > *Tasks, int Threads);
-	void run();
+	explicit CTaskGroup(const std::string & name, CThreadPool & pool = CThreadPool::get());
+	~CTaskGroup();
+
+	/// Queues task in pool
+	void run(Task task);
+
+	/// Executes task in calling thread, counted as part of group
+	void runHere(const Task & task);
+
+	/// Blocks until all tasks are finished, executing pending tasks of pool meanwhile. Rethrows first exception of tasks.
+	void wait();
 };
 
 template <typename T> inline void setData(T * data, std::function<T()> func)
@@ -89,12 +89,13 @@ CBonusProxy::CBonusProxy(const IBonusBearer * Target, CSelector Selector):
 
 TBonusListPtr CBonusProxy::get() const
 {
-	if(CBonusSystemNode::treeChanged != cachedLast || !data)
+	const int64_t treeVersion = target->getTreeVersion();
+	if(treeVersion != cachedLast || !data)
 	{
 		//TODO: support limiters
 		data = target->getAllBonuses(selector, nullptr);
 		data->eliminateDuplicates();
-		cachedLast = CBonusSystemNode::treeChanged;
+		cachedLast = treeVersion;
 	}
 	return data;
 }
@@ -104,25 +105,23 @@ const BonusList * CBonusProxy::operator->() const
 	return get().get();
 }
 
-int CBonusSystemNode::treeChanged = 1;
+std::atomic<int64_t> CBonusSystemNode::treeChanged(1);
+std::atomic<int64_t> CBonusSystemNode::treeWideChanged(1);
 const bool CBonusSystemNode::cachingEnabled = true;
 
-BonusList::BonusList(bool BelongsToTree) : belongsToTree(BelongsToTree)
+BonusList::BonusList(CBonusSystemNode * Owner) : owner(Owner)
 {
 
 }
 
-BonusList::BonusList(const BonusList &bonusList)
+BonusList::BonusList(const BonusList &bonusList) : owner(nullptr)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
-	belongsToTree = false;
 }
 
-BonusList::BonusList(BonusList&& other):
-	belongsToTree(false)
+BonusList::BonusList(BonusList&& other) : owner(nullptr)
 {
-	std::swap(belongsToTree, other.belongsToTree);
 	std::swap(bonuses, other.bonuses);
 }
 
@@ -130,14 +129,14 @@ BonusList& BonusList::operator=(const BonusList &bonusList)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
-	belongsToTree = false;
+	changed();
 	return *this;
 }
 
 void BonusList::changed()
 {
-    if(belongsToTree)
-		CBonusSystemNode::treeHasChanged();
+	if(owner)
+		owner->nodeHasChanged();
 }
 
 int BonusList::totalValue() const
@@ -326,14 +325,7 @@ int IBonusBearer::valOfBonuses(Bonus::BonusType type, const CSelector &selector)
 
 int IBonusBearer::valOfBonuses(Bonus::BonusType type, int subtype) const
 {
-	std::stringstream cachingStr;
-	cachingStr << "type_" << type << "s_" << subtype;
-
-	CSelector s = Selector::type(type);
-	if(subtype != -1)
-		s = s.And(Selector::subtype(subtype));
-
-	return valOfBonuses(s, cachingStr.str());
+	return getTypeQueryResult(type, subtype).value;
 }
 
 int IBonusBearer::valOfBonuses(const CSelector &selector, const std::string &cachingStr) const
@@ -354,14 +346,7 @@ bool IBonusBearer::hasBonus(const CSelector &selector, const CSelector &limit, c
 
 bool IBonusBearer::hasBonusOfType(Bonus::BonusType type, int subtype) const
 {
-	std::stringstream cachingStr;
-	cachingStr << "type_" << type << "s_" << subtype;
-
-	CSelector s = Selector::type(type);
-	if(subtype != -1)
-		s = s.And(Selector::subtype(subtype));
-
-	return hasBonus(s, cachingStr.str());
+	return getTypeQueryResult(type, subtype).count > 0;
 }
 
 const TBonusListPtr IBonusBearer::getBonuses(const CSelector &selector, const std::string &cachingStr) const
@@ -381,6 +366,25 @@ bool IBonusBearer::hasBonusFrom(Bonus::BonusSource source, ui32 sourceID) const
 	return hasBonus(Selector::source(source,sourceID), cachingStr.str());
 }
 
+BonusTypeQueryResult IBonusBearer::getTypeQueryResult(Bonus::BonusType type, int subtype) const
+{
+	std::stringstream cachingStr;
+	cachingStr << "type_" << type << "s_" << subtype;
+
+	CSelector s = Selector::type(type);
+	if(subtype != -1)
+		s = s.And(Selector::subtype(subtype));
+
+	auto bonuses = getBonuses(s, cachingStr.str());
+	return {bonuses->totalValue(), static_cast<int>(bonuses->size())};
+}
+
+int64_t IBonusBearer::getTreeVersion() const
+{
+	//generic bearer can not track its dependencies, so any change in tree is relevant
+	return CBonusSystemNode::treeChanged;
+}
+
 int IBonusBearer::MoraleVal() const
 {
 	if(hasBonusOfType(Bonus::NON_LIVING) || hasBonusOfType(Bonus::UNDEAD) ||
@@ -573,45 +577,45 @@ const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, c
 	bool limitOnUs = (!root || root == this); //caching won't work when we want to limit bonuses against an external node
 	if (CBonusSystemNode::cachingEnabled && limitOnUs)
 	{
-		// Exclusive access for one thread
-		static boost::mutex m;
-		boost::mutex::scoped_lock lock(m);
-
-		// If the bonus system tree changes(state of a single node or the relations to each other) then
-		// cache all bonus objects. Selector objects doesn't matter.
-		if (cachedLast != treeChanged)
+		const int64_t treeVersion = getTreeVersion();
+		TBonusListPtr snapshot;
 		{
-			cachedBonuses.clear();
-			cachedRequests.clear();
-
-			BonusList allBonuses;
-			getAllBonusesRec(allBonuses);
-			allBonuses.eliminateDuplicates();
-			limitBonuses(allBonuses, cachedBonuses);
-
-			cachedLast = treeChanged;
-		}
+			// Exclusive access to this node only, queries on other nodes are not blocked
+			boost::mutex::scoped_lock lock(cacheMutex);
 
-		// If a bonus system request comes with a caching string then look up in the map if there are any
-		// pre-calculated bonus results. Limiters can't be cached so they have to be calculated.
-		if (cachingStr != "")
-		{
-			auto it = cachedRequests.find(cachingStr);
-			if(it != cachedRequests.end())
+			// If this node or any of its ancestors changed (state of a single node or the relations to each other) then
+			// cache all bonus objects. Selector objects doesn't matter.
+			if (cachedLast != treeVersion)
+			{
+				rebuildCache(treeVersion);
+			}
+			// If a bonus system request comes with a caching string then look up in the map if there are any
+			// pre-calculated bonus results. Limiters can't be cached so they have to be calculated.
+			else if (cachingStr != "")
 			{
-				//Cached list contains bonuses for our query with applied limiters
-				return it->second;
+				auto it = cachedRequests.find(cachingStr);
+				if(it != cachedRequests.end())
+				{
+					//Cached list contains bonuses for our query with applied limiters
+					return it->second;
+				}
 			}
+
+			snapshot = cachedBonuses;
 		}
 
 		//We still don't have the bonuses (didn't returned them from cache)
-		//Perform bonus selection
+		//Perform bonus selection on snapshot without holding the lock
 		auto ret = std::make_shared<BonusList>();
-		cachedBonuses.getBonuses(*ret, selector, limit);
+		snapshot->getBonuses(*ret, selector, limit);
 
-		// Save the results in the cache
+		// Save the results in the cache unless snapshot was replaced in the meantime
 		if(cachingStr != "")
-			cachedRequests[cachingStr] = ret;
+		{
+			boost::mutex::scoped_lock lock(cacheMutex);
+			if(cachedLast == treeVersion)
+				cachedRequests[cachingStr] = ret;
+		}
 
 		return ret;
 	}
@@ -621,6 +625,61 @@ const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, c
 	}
 }
 
+BonusTypeQueryResult CBonusSystemNode::getTypeQueryResult(Bonus::BonusType type, int subtype) const
+{
+	if(!CBonusSystemNode::cachingEnabled)
+		return IBonusBearer::getTypeQueryResult(type, subtype);
+
+	const ui64 key = (static_cast<ui64>(type) << 32) | static_cast<ui32>(subtype);
+	const int64_t treeVersion = getTreeVersion();
+	TBonusListPtr snapshot;
+	{
+		boost::mutex::scoped_lock lock(cacheMutex);
+
+		if (cachedLast != treeVersion)
+		{
+			rebuildCache(treeVersion);
+		}
+		else
+		{
+			auto it = cachedTypeQueries.find(key);
+			if(it != cachedTypeQueries.end())
+				return {it->second->totalValue(), static_cast<int>(it->second->size())};
+		}
+
+		snapshot = cachedBonuses;
+	}
+
+	auto matching = std::make_shared<BonusList>();
+	for(auto & b : *snapshot)
+	{
+		// same as BonusList::getBonuses without limit - bonuses with limited effect range apply only when asked for explicitly
+		if(b->type == type && (subtype == -1 || b->subtype == subtype) && b->effectRange == Bonus::NO_LIMIT)
+			matching->push_back(b);
+	}
+
+	{
+		boost::mutex::scoped_lock lock(cacheMutex);
+		if(cachedLast == treeVersion)
+			cachedTypeQueries[key] = matching;
+	}
+
+	return {matching->totalValue(), static_cast<int>(matching->size())};
+}
+
+void CBonusSystemNode::rebuildCache(int64_t treeVersion) const
+{
+	cachedRequests.clear();
+	cachedTypeQueries.clear();
+
+	BonusList allBonuses;
+	getAllBonusesRec(allBonuses);
+	allBonuses.eliminateDuplicates();
+	cachedBonuses = limitBonuses(allBonuses);
+
+	cachedLast = treeVersion;
+}
+
 const TBonusListPtr CBonusSystemNode::getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root) const
 {
 	auto ret = std::make_shared<BonusList>();
@@ -657,7 +716,7 @@ const TBonusListPtr CBonusSystemNode::getAllBonusesWithoutCaching(const CSelecto
 	return ret;
 }
 
-CBonusSystemNode::CBonusSystemNode() : bonuses(true), exportedBonuses(true), nodeType(UNKNOWN), cachedLast(0)
+CBonusSystemNode::CBonusSystemNode() : bonuses(this), exportedBonuses(this), nodeType(UNKNOWN), cachedLast(0), nodeChanged(0)
 {
 }
 
@@ -666,8 +725,11 @@ CBonusSystemNode::CBonusSystemNode(CBonusSystemNode && other):
 	exportedBonuses(std::move(other.exportedBonuses)),
 	nodeType(other.nodeType),
 	description(other.description),
-	cachedLast(0)
+	cachedLast(0),
+	nodeChanged(0)
 {
+	bonuses.owner = this;
+	exportedBonuses.owner = this;
 	std::swap(parents, other.parents);
 	std::swap(children, other.children);
 
@@ -713,7 +775,7 @@ void CBonusSystemNode::attachTo(CBonusSystemNode *parent)
 		newRedDescendant(parent);
 
 	parent->newChildAttached(this);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::detachFrom(CBonusSystemNode *parent)
@@ -727,7 +789,7 @@ void CBonusSystemNode::detachFrom(CBonusSystemNode *parent)
 
 	parents -= parent;
 	parent->childDetached(this);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::popBonuses(const CSelector &s)
@@ -767,14 +829,16 @@ void CBonusSystemNode::addNewBonus(const std::shared_ptr<Bonus>& b)
 	assert(!vstd::contains(exportedBonuses, b));
 	exportedBonuses.push_back(b);
 	exportBonus(b);
-	CBonusSystemNode::treeHasChanged();
 }
 
 void CBonusSystemNode::accumulateBonus(const std::shared_ptr<Bonus>& b)
 {
 	auto bonus = exportedBonuses.getFirst(Selector::typeSubtype(b->type, b->subtype)); //only local bonuses are interesting //TODO: what about value type?
 	if(bonus)
+	{
 		bonus->val += b->val;
+		nodeHasChanged();
+	}
 	else
 		addNewBonus(std::make_shared<Bonus>(*b)); //duplicate needed, original may get destroyed
 }
@@ -786,7 +850,7 @@ void CBonusSystemNode::removeBonus(const std::shared_ptr<Bonus>& b)
 		unpropagateBonus(b);
 	else
 		bonuses -= b;
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 bool CBonusSystemNode::actsAsBonusSourceOnly() const
@@ -807,6 +871,7 @@ void CBonusSystemNode::propagateBonus(std::shared_ptr<Bonus> b)
 	if(b->propagator->shouldBeAttached(this))
 	{
 		bonuses.push_back(b);
+		nodeHasChanged();
 		logBonus->trace("#$# %s #propagated to# %s",  b->Description(), nodeName());
 	}
 
@@ -824,6 +889,7 @@ void CBonusSystemNode::unpropagateBonus(std::shared_ptr<Bonus> b)
 			logBonus->error("Bonus was duplicated (%s) at %s", b->Description(), nodeName());
 			bonuses -= b;
 		}
+		nodeHasChanged();
 		logBonus->trace("#$# %s #is no longer propagated to# %s",  b->Description(), nodeName());
 	}
 
@@ -952,7 +1018,7 @@ void CBonusSystemNode::exportBonus(std::shared_ptr<Bonus> b)
 	else
 		bonuses.push_back(b);
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::exportBonuses()
@@ -1043,9 +1109,29 @@ TBonusListPtr CBonusSystemNode::limitBonuses(const BonusList &allBonuses) const
 	return ret;
 }
 
+int64_t CBonusSystemNode::getTreeVersion() const
+{
+	return std::max(nodeChanged, treeWideChanged.load());
+}
+
+void CBonusSystemNode::nodeHasChanged()
+{
+	invalidateDescendants(++treeChanged);
+}
+
+void CBonusSystemNode::invalidateDescendants(int64_t version)
+{
+	if(nodeChanged == version)
+		return; //already reached through another parent
+
+	nodeChanged = version;
+	for(CBonusSystemNode * child : children)
+		child->invalidateDescendants(version);
+}
+
 void CBonusSystemNode::treeHasChanged()
 {
-	treeChanged++;
+	treeWideChanged = ++treeChanged;
 }
 
 int NBonus::valOf(const CBonusSystemNode *obj, Bonus::BonusType type, int subtype)
@@ -1134,6 +1220,71 @@ std::shared_ptr<Bonus> Bonus::addPropagator(TPropagatorPtr Propagator)
 	return this->shared_from_this();
 }
 
+CBonusFieldMatcher::CBonusFieldMatcher()
+	: fields(0)
+{
+	std::fill(std::begin(values), std::end(values), 0);
+}
+
+bool CBonusFieldMatcher::addField(ui8 field, si32 value)
+{
+	for(int i = 0; i < FIELDS_COUNT; i++)
+	{
+		if(field & (1 << i))
+		{
+			if((fields & (1 << i)) && values[i] != value)
+				return false;
+			values[i] = value;
+		}
+	}
+	fields |= field;
+	return true;
+}
+
+bool CBonusFieldMatcher::merge(const CBonusFieldMatcher & other)
+{
+	for(int i = 0; i < FIELDS_COUNT; i++)
+	{
+		if((other.fields & (1 << i)) && !addField(1 << i, other.values[i]))
+			return false;
+	}
+	return true;
+}
+
+ui8 matcherFieldOf(Bonus::BonusType Bonus::*ptr)
+{
+	return ptr == &Bonus::type ? CBonusFieldMatcher::TYPE : 0;
+}
+
+ui8 matcherFieldOf(si32 Bonus::*ptr)
+{
+	if(ptr == &Bonus::subtype)
+		return CBonusFieldMatcher::SUBTYPE;
+	if(ptr == &Bonus::additionalInfo)
+		return CBonusFieldMatcher::INFO;
+	return 0;
+}
+
+ui8 matcherFieldOf(Bonus::BonusSource Bonus::*ptr)
+{
+	return ptr == &Bonus::source ? CBonusFieldMatcher::SOURCE : 0;
+}
+
+ui8 matcherFieldOf(ui32 Bonus::*ptr)
+{
+	return ptr == &Bonus::sid ? CBonusFieldMatcher::SOURCE_ID : 0;
+}
+
+ui8 matcherFieldOf(Bonus::ValueType Bonus::*ptr)
+{
+	return ptr == &Bonus::valType ? CBonusFieldMatcher::VALUE_TYPE : 0;
+}
+
+ui8 matcherFieldOf(Bonus::LimitEffect Bonus::*ptr)
+{
+	return ptr == &Bonus::effectRange ? CBonusFieldMatcher::EFFECT_RANGE : 0;
+}
+
 namespace Selector
 {
 	DLL_LINKAGE CSelectFieldEqual<Bonus::BonusType> type(&Bonus::type);
@@ -1172,7 +1323,7 @@ namespace Selector
 		return CSelectFieldEqual<Bonus::ValueType>(&Bonus::valType)(valType);
 	}
 
-	DLL_LINKAGE CSelector all([](const Bonus * b){return true;});
+	DLL_LINKAGE CSelector all = CBonusFieldMatcher();
 	DLL_LINKAGE CSelector none([](const Bonus * b){return false;});
 
 	bool DLL_LINKAGE matchesType(const CSelector &sel, Bonus::BonusType type)
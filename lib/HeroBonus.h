@@ -26,23 +26,70 @@ typedef std::set<CBonusSystemNode*> TNodes;
 typedef std::set<const CBonusSystemNode*> TCNodes;
 typedef std::vector<CBonusSystemNode *> TNodesVector;
 
+/// Conjunction of equality tests on plain bonus fields
+/// Evaluated by comparing all fields at once, without any indirect calls
+class DLL_LINKAGE CBonusFieldMatcher
+{
+public:
+	enum EField : ui8
+	{
+		TYPE = 1,
+		SUBTYPE = 2,
+		SOURCE = 4,
+		SOURCE_ID = 8,
+		VALUE_TYPE = 16,
+		INFO = 32,
+		EFFECT_RANGE = 64
+	};
+
+	CBonusFieldMatcher(); //matches every bonus
+
+	///adds test for field, returns false if field is already tested against other value
+	bool addField(ui8 field, si32 value);
+	///adds all tests of other matcher, returns false if they contradict tests of this one
+	bool merge(const CBonusFieldMatcher & other);
+
+	inline bool operator()(const Bonus * b) const;
+
+private:
+	static const int FIELDS_COUNT = 7;
+
+	ui8 fields; //bitmask of tested fields
+	si32 values[FIELDS_COUNT];
+};
+
 class CSelector : std::function<bool(const Bonus*)>
 {
 	typedef std::function<bool(const Bonus*)> TBase;
+
+	//if set, selector consists only of field equality tests and std::function is not used
+	CBonusFieldMatcher matcher;
+	bool hasMatcher;
 public:
-	CSelector() {}
+	CSelector() : hasMatcher(false) {}
 	template<typename T>
 	CSelector(const T &t,	//SFINAE trick -> include this c-tor in overload resolution only if parameter is class
 							//(includes functors, lambdas) or function. Without that VC is going mad about ambiguities.
 		typename std::enable_if < boost::mpl::or_ < std::is_class<T>, std::is_function<T >> ::value>::type *dummy = nullptr)
-		: TBase(t)
+		: TBase(t), hasMatcher(false)
+	{}
+
+	CSelector(const CBonusFieldMatcher & Matcher)
+		: matcher(Matcher), hasMatcher(true)
 	{}
 
-	CSelector(std::nullptr_t)
+	CSelector(std::nullptr_t) : hasMatcher(false)
 	{}
 
 	CSelector And(CSelector rhs) const
 	{
+		if(hasMatcher && rhs.hasMatcher)
+		{
+			CBonusFieldMatcher merged = matcher;
+			if(merged.merge(rhs.matcher))
+				return merged;
+		}
+
 		//lambda may likely outlive "this" (it can be even a temporary) => we copy the OBJECT (not pointer)
 		auto thisCopy = *this;
 		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) && rhs(b); };
@@ -53,14 +100,11 @@ public:
 		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) || rhs(b); };
 	}
 
-	bool operator()(const Bonus *b) const
-	{
-		return TBase::operator()(b);
-	}
+	inline bool operator()(const Bonus *b) const;
 
 	operator bool() const
 	{
-		return !!static_cast<const TBase&>(*this);
+		return hasMatcher || !!static_cast<const TBase&>(*this);
 	}
 };
 
@@ -73,7 +117,7 @@ public:
 
 	const BonusList * operator->() const;
 private:
-	mutable int cachedLast;
+	mutable int64_t cachedLast;
 	const IBonusBearer * target;
 	CSelector selector;
 	mutable TBonusListPtr data;
@@ -429,9 +473,11 @@ public:
 
 private:
 	TInternalContainer bonuses;
-	bool belongsToTree;
+	CBonusSystemNode * owner; //node that wields these bonuses, its caches are invalidated whenever list changes
 	void changed();
 
+	friend class CBonusSystemNode;
+
 public:
 	typedef TInternalContainer::const_reference const_reference;
 	typedef TInternalContainer::value_type value_type;
@@ -439,7 +485,7 @@ public:
 	typedef TInternalContainer::const_iterator const_iterator;
 	typedef TInternalContainer::iterator iterator;
 
-	BonusList(bool BelongsToTree = false);
+	BonusList(CBonusSystemNode * Owner = nullptr);
 	BonusList(const BonusList &bonusList);
 	BonusList(BonusList && other);
 	BonusList& operator=(const BonusList &bonusList);
@@ -584,6 +630,13 @@ public:
 	}
 };
 
+/// Total value and number of bonuses of one type (and optionally subtype) visible on bearer
+struct BonusTypeQueryResult
+{
+	int value;
+	int count;
+};
+
 class DLL_LINKAGE IBonusBearer
 {
 public:
@@ -606,6 +659,9 @@ public:
 	bool hasBonusOfType(Bonus::BonusType type, int subtype = -1) const;//determines if hero has a bonus of given type (and optionally subtype)
 	bool hasBonusFrom(Bonus::BonusSource source, ui32 sourceID) const;
 
+	//returns version of bonus tree relevant for this bearer, it changes whenever bonuses visible here may have changed
+	virtual int64_t getTreeVersion() const;
+
 	//various hlp functions for non-trivial values
 	ui32 getMinDamage() const; //used for stacks and creatures only
 	ui32 getMaxDamage() const;
@@ -620,6 +676,10 @@ public:
 
 	si32 manaLimit() const; //maximum mana value for this hero (basically 10*knowledge)
 	int getPrimSkillLevel(PrimarySkill::PrimarySkill id) const;
+
+protected:
+	//backend of legacy interface, subtype -1 means any; nodes cache result by type and subtype without building caching strings
+	virtual BonusTypeQueryResult getTypeQueryResult(Bonus::BonusType type, int subtype) const;
 };
 
 class DLL_LINKAGE CBonusSystemNode : public IBonusBearer, public boost::noncopyable
@@ -641,18 +701,27 @@ private:
 	std::string description;
 
 	static const bool cachingEnabled;
-	mutable BonusList cachedBonuses;
-	mutable int cachedLast;
-	static int treeChanged;
+	mutable boost::mutex cacheMutex; //guards cache of this node, queries on different nodes run in parallel
+	mutable TBonusListPtr cachedBonuses; //never modified once published, readers may keep using it without lock
+	mutable int64_t cachedLast;
+	int64_t nodeChanged; //tree version at which this node or one of its ancestors was last changed
+	static std::atomic<int64_t> treeChanged; //global version counter, incremented on every change
+	static std::atomic<int64_t> treeWideChanged; //tree version of last change that invalidated all nodes
 
 	// Setting a value to cachingStr before getting any bonuses caches the result for later requests.
 	// This string needs to be unique, that's why it has to be setted in the following manner:
 	// [property key]_[value] => only for selector
 	mutable std::map<std::string, TBonusListPtr > cachedRequests;
+	// Bonuses selected by legacy queries by type and subtype, keyed by both packed into integer
+	// Only lists are kept, values are summed on each query so bonuses modified in place are never stale
+	mutable std::unordered_map<ui64, TBonusListPtr> cachedTypeQueries;
 
 	void getBonusesRec(BonusList &out, const CSelector &selector, const CSelector &limit) const;
 	void getAllBonusesRec(BonusList &out) const;
 	const TBonusListPtr getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root = nullptr) const;
+	void rebuildCache(int64_t treeVersion) const; //cacheMutex must be locked
+	void invalidateDescendants(int64_t version);
+	BonusTypeQueryResult getTypeQueryResult(Bonus::BonusType type, int subtype) const override;
 
 public:
 	explicit CBonusSystemNode();
@@ -708,7 +777,11 @@ public:
 	const TNodesVector &getChildrenNodes() const;
 	const std::string &getDescription() const;
 	void setDescription(const std::string &description);
+	int64_t getTreeVersion() const override;
 
+	///invalidates bonus caches of this node and all its descendants
+	void nodeHasChanged();
+	///invalidates bonus caches of all nodes, use when change can not be attributed to a single node
 	static void treeHasChanged();
 
 	template <typename Handler> void serialize(Handler &h, const int version)
@@ -721,7 +794,7 @@ public:
 		//h & parents & children;
 	}
 
-	friend class CBonusProxy;
+	friend class IBonusBearer;
 };
 
 namespace NBonus
@@ -731,19 +804,40 @@ namespace NBonus
 	DLL_LINKAGE bool hasOfType(const CBonusSystemNode *obj, Bonus::BonusType type, int subtype = -1);//determines if hero has a bonus of given type (and optionally subtype)
 }
 
+//CBonusFieldMatcher field corresponding to member of Bonus, 0 if member can be tested only by lambda
+template<typename T>
+ui8 matcherFieldOf(T Bonus::*ptr)
+{
+	return 0;
+}
+DLL_LINKAGE ui8 matcherFieldOf(Bonus::BonusType Bonus::*ptr);
+DLL_LINKAGE ui8 matcherFieldOf(si32 Bonus::*ptr);
+DLL_LINKAGE ui8 matcherFieldOf(Bonus::BonusSource Bonus::*ptr);
+DLL_LINKAGE ui8 matcherFieldOf(ui32 Bonus::*ptr);
+DLL_LINKAGE ui8 matcherFieldOf(Bonus::ValueType Bonus::*ptr);
+DLL_LINKAGE ui8 matcherFieldOf(Bonus::LimitEffect Bonus::*ptr);
+
 template<typename T>
 class CSelectFieldEqual
 {
 	T Bonus::*ptr;
+	ui8 matcherField;
 
 public:
 	CSelectFieldEqual(T Bonus::*Ptr)
-		: ptr(Ptr)
+		: ptr(Ptr), matcherField(matcherFieldOf(Ptr))
 	{
 	}
 
 	CSelector operator()(const T &valueToCompareAgainst) const
 	{
+		if(matcherField)
+		{
+			CBonusFieldMatcher matcher;
+			matcher.addField(matcherField, static_cast<si32>(valueToCompareAgainst));
+			return matcher;
+		}
+
 		auto ptr2 = ptr; //We need a COPY because we don't want to reference this (might be outlived by lambda)
 		return [ptr2, valueToCompareAgainst](const Bonus *bonus) {  return bonus->*ptr2 == valueToCompareAgainst; };
 	}
@@ -986,6 +1080,23 @@ extern DLL_LINKAGE const std::map<std::string, TLimiterPtr> bonusLimiterMap;
 extern DLL_LINKAGE const std::map<std::string, TPropagatorPtr> bonusPropagatorMap;
 
 
+inline bool CBonusFieldMatcher::operator()(const Bonus * b) const
+{
+	//type is tested by almost every selector and rejects most bonuses, so it goes first
+	return !((fields & TYPE) && b->type != values[0])
+		&& !((fields & SUBTYPE) && b->subtype != values[1])
+		&& !((fields & SOURCE) && b->source != values[2])
+		&& !((fields & SOURCE_ID) && static_cast<si32>(b->sid) != values[3])
+		&& !((fields & VALUE_TYPE) && b->valType != values[4])
+		&& !((fields & INFO) && b->additionalInfo != values[5])
+		&& !((fields & EFFECT_RANGE) && b->effectRange != values[6]);
+}
+
+inline bool CSelector::operator()(const Bonus *b) const
+{
+	return hasMatcher ? matcher(b) : TBase::operator()(b);
+}
+
 // BonusList template that requires full interface of CBonusSystemNode
 template <class InputIterator>
 void BonusList::insert(const int position, InputIterator first, InputIterator last)
@@ -64,21 +64,23 @@ void CPrivilagedInfoCallback::getTilesInRange(std::unordered_set<int3, ShashInt3
 	else
 	{
 		const TeamState * team = !player ? nullptr : gs->getPlayerTeam(*player);
-		for (int xd = std::max<int>(pos.x - radious , 0); xd <= std::min<int>(pos.x + radious, gs->map->width - 1); xd++)
+		const std::vector<int> spans = CFogOfWarMap::getRangeSpans(radious, distanceFormula);
+		const int rows = spans.size();
+		for (int dy = 1 - rows; dy < rows; dy++)
 		{
-			for (int yd = std::max<int>(pos.y - radious, 0); yd <= std::min<int>(pos.y + radious, gs->map->height - 1); yd++)
+			const int yd = pos.y + dy;
+			if (yd < 0 || yd >= gs->map->height)
+				continue;
+
+			const int halfWidth = spans[std::abs(dy)];
+			for (int xd = std::max<int>(pos.x - halfWidth, 0); xd <= std::min<int>(pos.x + halfWidth, gs->map->width - 1); xd++)
 			{
 				int3 tilePos(xd,yd,pos.z);
-				double distance = pos.dist(tilePos, distanceFormula);
-
-				if(distance <= radious)
-				{
-					if(!player
-						|| (mode == 1  && team->fogOfWarMap[xd][yd][pos.z]==0)
-						|| (mode == -1 && team->fogOfWarMap[xd][yd][pos.z]==1)
-					)
-						tiles.insert(int3(xd,yd,pos.z));
-				}
+				if(!player
+					|| (mode == 1  && !team->fogOfWarMap.isVisible(tilePos))
+					|| (mode == -1 && team->fogOfWarMap.isVisible(tilePos))
+				)
+					tiles.insert(tilePos);
 			}
 		}
 	}
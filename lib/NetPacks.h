@@ -16,6 +16,7 @@
 #include "mapObjects/CGHeroInstance.h"
 #include "ConstTransitivePtr.h"
 #include "int3.h"
+#include "CFogOfWarMap.h"
 #include "ResourceSet.h"
 #include "CGameStateFwd.h"
 #include "mapping/CMapDefines.h"
@@ -352,7 +353,7 @@ struct FoWChange : public CPackForClient
 	bool waitForDialogs;
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
-		h & tiles;
+		TileRun::serializeTiles(h, tiles);
 		h & player;
 		h & mode;
 		h & waitForDialogs;
@@ -653,7 +654,7 @@ struct TryMoveHero : public CPackForClient
 		h & start;
 		h & end;
 		h & movePoints;
-		h & fowRevealed;
+		TileRun::serializeTiles(h, fowRevealed);
 		h & attackedFrom;
 	}
 };
@@ -25,14 +25,20 @@
 #include "CModHandler.h"
 #include "IGameEventsReceiver.h"
 #include "CStopWatch.h"
+#include "CThreadHelper.h"
 #include "VCMIDirs.h"
 #include "filesystem/Filesystem.h"
 #include "CConsoleHandler.h"
+#include "CConfigHandler.h"
 #include "rmg/CRmgTemplateStorage.h"
 #include "mapping/CMapEditManager.h"
+#include "serializer/BinaryDeserializer.h"
+#include "serializer/BinarySerializer.h"
 
 LibClasses * VLC = nullptr;
 
+static const std::string DATABASE_SNAPSHOT_MAGIC = "VCMIDATABASE";
+
 DLL_LINKAGE void preinitDLL(CConsoleHandler *Console)
 {
 	console = Console;
@@ -93,6 +99,7 @@ template <class Handler> void createHandler(Handler *&handler, const std::string
 void LibClasses::init()
 {
 	CStopWatch pomtime, totalTime;
+	CThreadPool::get().resetStats();
 
 	modh->initializeConfig();
 
@@ -100,6 +107,22 @@ void LibClasses::init()
 
 	createHandler(generaltexth, "General text", pomtime);
 
+	createHandler(terviewh, "Terrain view pattern", pomtime);
+
+	modh->calculateChecksums();
+
+	const boost::filesystem::path snapshotFile = VCMIDirs::get().userCachePath() / "gameDatabase.dat";
+	if(loadDatabaseSnapshot(snapshotFile))
+	{
+		logGlobal->info("\tRestoring game database: %d ms", pomtime.getDiff());
+		CThreadPool::get().logStats("Restoring game database");
+
+		createHandler(tplh, "Template", pomtime);
+		modh->loadTemplates();
+		modh->afterLoad();
+		return;
+	}
+
 	createHandler(heroh, "Hero", pomtime);
 
 	createHandler(arth, "Artifact", pomtime);
@@ -116,20 +139,99 @@ void LibClasses::init()
 
 	createHandler(skillh, "Skill", pomtime);
 
-	createHandler(terviewh, "Terrain view pattern", pomtime);
-
 	createHandler(tplh, "Template", pomtime); //templates need already resolved identifiers (refactor?)
 
 	logGlobal->info("\tInitializing handlers: %d ms", totalTime.getDiff());
 
 	modh->load();
 
+	saveDatabaseSnapshot(snapshotFile);
+	CThreadPool::get().logStats("Saving game database");
+
 	modh->afterLoad();
 
 	//FIXME: make sure that everything is ok after game restart
 	//TODO: This should be done every time mod config changes
 }
 
+bool LibClasses::loadDatabaseSnapshot(const boost::filesystem::path & fname)
+{
+	if(!boost::filesystem::exists(fname))
+		return false;
+
+	// handlers register their identifiers on creation, restore them if snapshot is not usable
+	const CIdentifierStorage identifiers = modh->identifiers;
+	const auto modSettings = modh->settings;
+	const auto modModules = modh->modules;
+	try
+	{
+		CLoadFile lf(fname, SERIALIZATION_VERSION);
+		lf.checkMagicBytes(DATABASE_SNAPSHOT_MAGIC);
+
+		std::vector<std::pair<TModID, ui32>> checksums;
+		std::string encoding;
+		lf >> checksums >> encoding;
+		if(checksums != modh->getChecksums() || encoding != settings["general"]["encoding"].String())
+		{
+			logGlobal->info("Game database snapshot is outdated, loading content from mods");
+			return false;
+		}
+
+		lf >> heroh >> arth >> creh >> townh >> objh >> objtypeh >> spellh >> skillh;
+		lf >> modh->identifiers >> modh->settings >> modh->modules;
+		return true;
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->error("Failed to load game database snapshot: %s", e.what());
+		// drop partially loaded handlers, content is loaded into new ones
+		delete heroh;
+		delete arth;
+		delete creh;
+		delete townh;
+		delete objh;
+		delete objtypeh;
+		delete spellh;
+		delete skillh;
+		heroh = nullptr;
+		arth = nullptr;
+		creh = nullptr;
+		townh = nullptr;
+		objh = nullptr;
+		objtypeh = nullptr;
+		spellh = nullptr;
+		skillh = nullptr;
+		modh->identifiers = identifiers;
+		modh->settings = modSettings;
+		modh->modules = modModules;
+		return false;
+	}
+}
+
+void LibClasses::saveDatabaseSnapshot(const boost::filesystem::path & fname) const
+{
+	// write to temporary file first, so interrupted save never leaves broken snapshot
+	// its name is unique, since client and server may both write snapshot at the same time
+	const boost::filesystem::path tempFile = boost::filesystem::unique_path(fname.string() + ".%%%%-%%%%.tmp");
+	try
+	{
+		{
+			CSaveFile sf(tempFile);
+			sf.putMagicBytes(DATABASE_SNAPSHOT_MAGIC);
+			sf << modh->getChecksums() << settings["general"]["encoding"].String();
+			sf << heroh << arth << creh << townh << objh << objtypeh << spellh << skillh;
+			sf << modh->identifiers << modh->settings << modh->modules;
+		}
+		boost::filesystem::rename(tempFile, fname);
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->error("Failed to save game database snapshot: %s", e.what());
+		boost::system::error_code ec;
+		boost::filesystem::remove(tempFile, ec);
+	}
+}
+
 void LibClasses::clear()
 {
 	delete generaltexth;
@@ -33,6 +33,11 @@ class DLL_LINKAGE LibClasses
 
 	void callWhenDeserializing(); //should be called only by serialize !!!
 	void makeNull(); //sets all handler pointers to null
+
+	/// Snapshot of handlers with all content loaded, valid only for same mods with same checksums
+	/// Random map templates are not serializable and always loaded from mods
+	bool loadDatabaseSnapshot(const boost::filesystem::path & fname);
+	void saveDatabaseSnapshot(const boost::filesystem::path & fname) const;
 public:
 	bool IS_AI_ENABLED; //unused?
 
@@ -13,6 +13,7 @@
 #include <zlib.h>
 
 static const int inflateBlockSize = 10000;
+static const int deflateBlockSize = 1 << 16;
 
 CBufferedStream::CBufferedStream():
     position(0),
@@ -189,3 +190,75 @@ bool CCompressedStream::getNextBlock()
 	reset();
 	return true;
 }
+
+CStreamCompressor::CStreamCompressor(std::ostream & output, int level):
+	output(output),
+	compressedBuffer(deflateBlockSize)
+{
+	deflateState = new z_stream();
+	deflateState->zalloc = Z_NULL;
+	deflateState->zfree = Z_NULL;
+	deflateState->opaque = Z_NULL;
+
+	int ret = deflateInit(deflateState, level);
+	if (ret != Z_OK)
+	{
+		vstd::clear_pointer(deflateState);
+		throw std::runtime_error("Failed to initialize deflate!\n");
+	}
+}
+
+CStreamCompressor::~CStreamCompressor()
+{
+	if (deflateState)
+	{
+		deflateEnd(deflateState);
+		vstd::clear_pointer(deflateState);
+	}
+}
+
+void CStreamCompressor::write(const ui8 * data, size_t size)
+{
+	assert(deflateState);
+
+	// avail_in is 32-bit, feed huge buffers in parts
+	while (size > 0)
+	{
+		const uInt part = static_cast<uInt>(std::min<size_t>(size, std::numeric_limits<uInt>::max()));
+		deflateState->next_in = const_cast<ui8 *>(data);
+		deflateState->avail_in = part;
+		deflateInput(Z_NO_FLUSH);
+		data += part;
+		size -= part;
+	}
+}
+
+void CStreamCompressor::finish()
+{
+	if (!deflateState)
+		return;
+
+	deflateState->next_in = Z_NULL;
+	deflateState->avail_in = 0;
+	deflateInput(Z_FINISH);
+	deflateEnd(deflateState);
+	vstd::clear_pointer(deflateState);
+	output.flush();
+}
+
+void CStreamCompressor::deflateInput(int flush)
+{
+	int ret;
+	do
+	{
+		deflateState->next_out = compressedBuffer.data();
+		deflateState->avail_out = compressedBuffer.size();
+
+		ret = deflate(deflateState, flush);
+		if (ret == Z_STREAM_ERROR)
+			throw std::runtime_error("Compression error!");
+
+		output.write(reinterpret_cast<const char *>(compressedBuffer.data()), compressedBuffer.size() - deflateState->avail_out);
+	}
+	while (deflateState->avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+}
@@ -135,3 +135,46 @@ private:
 		FINISHED
 	};
 };
+
+/**
+ * Compresses data into zlib stream readable by CCompressedStream (with gzip = false)
+ * and writes the result into output stream
+ */
+class DLL_LINKAGE CStreamCompressor : boost::noncopyable
+{
+public:
+	/**
+	 * C-tor.
+	 *
+	 * @param output - stream that receives compressed data, must outlive compressor
+	 * @param level - zlib compression level, -1 for zlib default
+	 */
+	CStreamCompressor(std::ostream & output, int level = -1);
+
+	~CStreamCompressor();
+
+	/**
+	 * Compresses n bytes. Data may be kept by zlib until more data is written or stream is finished.
+	 *
+	 * @throws std::runtime_error if compression failed
+	 */
+	void write(const ui8 * data, size_t size);
+
+	/**
+	 * Flushes all pending data and ends zlib stream. Nothing can be written afterwards
+	 *
+	 * @throws std::runtime_error if compression failed
+	 */
+	void finish();
+
+private:
+	void deflateInput(int flush);
+
+	std::ostream & output;
+
+	/** buffer for compressed data before it is written to output*/
+	std::vector<ui8> compressedBuffer;
+
+	/** struct with current zlib deflate state, nullptr once stream is finished */
+	z_stream_s * deflateState;
+};
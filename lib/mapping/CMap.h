@@ -352,8 +352,21 @@ public:
 	void initTerrain();
 
 	CMapEditManager * getEditManager();
-	TerrainTile & getTile(const int3 & tile);
-	const TerrainTile & getTile(const int3 & tile) const;
+	TerrainTile & getTile(const int3 & tile)
+	{
+		assert(isInTheMap(tile));
+		return terrain[getTileIndex(tile)];
+	}
+	const TerrainTile & getTile(const int3 & tile) const
+	{
+		assert(isInTheMap(tile));
+		return terrain[getTileIndex(tile)];
+	}
+	/// Index of tile in terrain and guardingCreaturePositions
+	size_t getTileIndex(const int3 & tile) const
+	{
+		return (static_cast<size_t>(tile.z) * height + tile.y) * width + tile.x;
+	}
 	bool isCoastalTile(const int3 & pos) const;
 	bool isInTheMap(const int3 & pos) const;
 	bool isWaterTile(const int3 & pos) const;
@@ -408,13 +421,13 @@ public:
 
 	std::unique_ptr<CMapEditManager> editManager;
 
-	int3 ***guardingCreaturePositions;
+	std::vector<int3> guardingCreaturePositions; //indexed by getTileIndex
 
 	std::map<std::string, ConstTransitivePtr<CGObjectInstance> > instanceNames;
 
 private:
-	/// a 3-dimensional array of terrain tiles, access is as follows: x, y, level. where level=1 is underground
-	TerrainTile*** terrain;
+	/// terrain tiles stored row by row, first all rows of surface, then underground
+	std::vector<TerrainTile> terrain;
 
 public:
 	template <typename Handler>
@@ -433,46 +446,20 @@ public:
 		h & questIdentifierToId;
 
 		//TODO: viccondetails
+		if(!h.saving)
+			initTerrain();
+
+		// tiles keep x, y, level order of old saves
 		int level = twoLevel ? 2 : 1;
-		if(h.saving)
+		for(int i = 0; i < width ; ++i)
 		{
-			// Save terrain
-			for(int i = 0; i < width ; ++i)
-			{
-				for(int j = 0; j < height ; ++j)
-				{
-					for(int k = 0; k < level; ++k)
-					{
-						h & terrain[i][j][k];
-						h & guardingCreaturePositions[i][j][k];
-					}
-				}
-			}
-		}
-		else
-		{
-			// Load terrain
-			terrain = new TerrainTile**[width];
-			guardingCreaturePositions = new int3**[width];
-			for(int i = 0; i < width; ++i)
-			{
-				terrain[i] = new TerrainTile*[height];
-				guardingCreaturePositions[i] = new int3*[height];
-				for(int j = 0; j < height; ++j)
-				{
-					terrain[i][j] = new TerrainTile[level];
-					guardingCreaturePositions[i][j] = new int3[level];
-				}
-			}
-			for(int i = 0; i < width ; ++i)
+			for(int j = 0; j < height ; ++j)
 			{
-				for(int j = 0; j < height ; ++j)
+				for(int k = 0; k < level; ++k)
 				{
-					for(int k = 0; k < level; ++k)
-					{
-						h & terrain[i][j][k];
-						h & guardingCreaturePositions[i][j][k];
-					}
+					const size_t index = getTileIndex(int3(i, j, k));
+					h & terrain[index];
+					h & guardingCreaturePositions[index];
 				}
 			}
 		}
@@ -10,11 +10,22 @@
 #include "StdInc.h"
 #include "CMapInfo.h"
 
-#include "../filesystem/ResourceID.h"
+#include "../filesystem/Filesystem.h"
+#include "../serializer/BinaryDeserializer.h"
+#include "../serializer/BinarySerializer.h"
 #include "../StartInfo.h"
+#include "../VCMI_Lib.h"
+#include "../CConfigHandler.h"
+#include "../CModHandler.h"
+#include "../CHeroHandler.h"
+#include "../CCreatureHandler.h"
 #include "../GameConstants.h"
+#include "../CThreadHelper.h"
+#include "../rmg/CMapGenOptions.h"
 #include "CMapService.h"
 
+static const std::string MAP_INDEX_MAGIC = "VCMIMAPIDX";
+
 void CMapInfo::countPlayers()
 {
 	actualHumanPlayers = playerAmnt = humanPlayers = 0;
@@ -92,3 +103,142 @@ CMapInfo & CMapInfo::operator=(CMapInfo &&tmp)
 }
 
 #undef STEAL
+
+CMapInfoIndex::CMapInfoIndex(const boost::filesystem::path & indexFile):
+	indexFile(indexFile)
+{
+}
+
+std::vector<CMapInfo> CMapInfoIndex::getInfos(const std::unordered_set<ResourceID> & files, const TParser & parser)
+{
+	std::map<std::string, Entry> oldEntries = loadIndex();
+	std::map<std::string, Entry> newEntries;
+
+	std::vector<ResourceID> toParse;
+	std::vector<std::string> toParsePaths; //empty path - file is not on disk and can't be indexed
+	std::vector<Entry> parsed;
+
+	for(auto & file : files)
+	{
+		std::string path;
+		Entry entry;
+		try
+		{
+			auto name = CResourceHandler::get()->getResourceName(file);
+			if(name)
+			{
+				path = name->string();
+				entry.size = boost::filesystem::file_size(*name);
+				entry.modified = boost::filesystem::last_write_time(*name);
+			}
+		}
+		catch(const boost::filesystem::filesystem_error & e)
+		{
+			logGlobal->warn("Can not index %s: %s", file.getName(), e.what());
+			path.clear();
+		}
+
+		auto old = oldEntries.find(path);
+		if(!path.empty() && old != oldEntries.end() && old->second.size == entry.size && old->second.modified == entry.modified)
+		{
+			newEntries.insert(std::make_pair(path, std::move(old->second)));
+			continue;
+		}
+
+		toParse.push_back(file);
+		toParsePaths.push_back(path);
+		parsed.push_back(std::move(entry));
+	}
+
+	if(!toParse.empty())
+	{
+		logGlobal->debug("Parsing %d files not found in %s", toParse.size(), indexFile.string());
+
+		CThreadPool::get().parallelFor("map headers", 0, toParse.size(), [&](size_t i)
+		{
+			try
+			{
+				parser(toParse[i], parsed[i].info);
+				parsed[i].valid = true;
+			}
+			catch(const std::exception & e)
+			{
+				logGlobal->error("Failed to process %s: %s", toParse[i].getName(), e.what());
+			}
+		});
+	}
+
+	std::vector<CMapInfo> ret;
+	ret.reserve(files.size());
+
+	for(size_t i = 0; i < toParse.size(); i++)
+	{
+		if(toParsePaths[i].empty())
+		{
+			if(parsed[i].valid)
+				ret.push_back(std::move(parsed[i].info));
+		}
+		else
+			newEntries.insert(std::make_pair(toParsePaths[i], std::move(parsed[i])));
+	}
+
+	if(!toParse.empty() || newEntries.size() != oldEntries.size())
+		saveIndex(newEntries);
+
+	for(auto & entry : newEntries)
+	{
+		if(entry.second.valid)
+			ret.push_back(std::move(entry.second.info));
+	}
+	return ret;
+}
+
+std::map<std::string, CMapInfoIndex::Entry> CMapInfoIndex::loadIndex() const
+{
+	std::map<std::string, Entry> ret;
+
+	if(!boost::filesystem::exists(indexFile))
+		return ret;
+
+	try
+	{
+		// index is rebuilt after any change of serialization format
+		CLoadFile lf(indexFile, SERIALIZATION_VERSION);
+		lf.checkMagicBytes(MAP_INDEX_MAGIC);
+
+		// texts in infos are decoded with selected encoding, and heroes, towns etc. in them may come from mods
+		std::vector<std::pair<TModID, ui32>> checksums;
+		std::string encoding;
+		lf >> checksums >> encoding;
+		if(checksums != VLC->modh->getChecksums() || encoding != settings["general"]["encoding"].String())
+		{
+			logGlobal->info("%s is outdated, all files will be parsed again", indexFile.string());
+			return ret;
+		}
+
+		lf >> ret;
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Failed to read %s, all files will be parsed again: %s", indexFile.string(), e.what());
+		ret.clear();
+	}
+	return ret;
+}
+
+void CMapInfoIndex::saveIndex(const std::map<std::string, Entry> & entries) const
+{
+	try
+	{
+		boost::filesystem::create_directories(indexFile.parent_path());
+
+		CSaveFile sf(indexFile);
+		sf.putMagicBytes(MAP_INDEX_MAGIC);
+		sf << VLC->modh->getChecksums() << settings["general"]["encoding"].String();
+		sf << entries;
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Failed to write %s: %s", indexFile.string(), e.what());
+	}
+}
@@ -19,6 +19,7 @@
 // available for Visual Studio for now. (Empty d-tor in .cpp would be required anyway)
 #include "CMap.h"
 #include "CCampaignHandler.h"
+#include "../filesystem/ResourceID.h"
 
 struct StartInfo;
 
@@ -62,3 +63,44 @@ public:
 		h & isRandomMap;
 	}
 };
+
+/**
+ * Parsed headers of map or save files, kept in index file between launches.
+ * Files are identified by path, size and modification time, only new or changed files are parsed again.
+ * Whole index is discarded when mods or text encoding change, since infos contain texts and mod content.
+ */
+class DLL_LINKAGE CMapInfoIndex
+{
+public:
+	/// Fills info from given file, throws if file is not valid
+	typedef std::function<void(const ResourceID & file, CMapInfo & info)> TParser;
+
+	CMapInfoIndex(const boost::filesystem::path & indexFile);
+
+	/// Returns infos of all valid files. Files not in index are parsed in parallel, index file is updated afterwards
+	std::vector<CMapInfo> getInfos(const std::unordered_set<ResourceID> & files, const TParser & parser);
+
+private:
+	struct Entry
+	{
+		ui64 size;
+		si64 modified;
+		bool valid; //invalid files are remembered too, so they are not parsed on every launch
+		CMapInfo info;
+
+		Entry() : size(0), modified(0), valid(false) {}
+
+		template <typename Handler> void serialize(Handler &h, const int Version)
+		{
+			h & size;
+			h & modified;
+			h & valid;
+			h & info;
+		}
+	};
+
+	const boost::filesystem::path indexFile;
+
+	std::map<std::string, Entry> loadIndex() const;
+	void saveIndex(const std::map<std::string, Entry> & entries) const;
+};
@@ -28,9 +28,11 @@
 #include "../serializer/BinaryDeserializer.h"
 #include "../serializer/BinarySerializer.h"
 #include "../serializer/CTypeList.h"
+#include "../serializer/CObjectCloner.h"
 
 template void registerTypesMapObjects1<BinaryDeserializer>(BinaryDeserializer & s);
 template void registerTypesMapObjects1<BinarySerializer>(BinarySerializer & s);
 template void registerTypesMapObjects1<CTypeList>(CTypeList & s);
+template void registerTypesMapObjects1<CObjectCloner>(CObjectCloner & s);
 
 
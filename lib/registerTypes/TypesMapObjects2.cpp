@@ -30,9 +30,11 @@
 #include "../serializer/BinaryDeserializer.h"
 #include "../serializer/BinarySerializer.h"
 #include "../serializer/CTypeList.h"
+#include "../serializer/CObjectCloner.h"
 
 
 template void registerTypesMapObjects2<BinaryDeserializer>(BinaryDeserializer & s);
 template void registerTypesMapObjects2<BinarySerializer>(BinarySerializer & s);
 template void registerTypesMapObjects2<CTypeList>(CTypeList & s);
+template void registerTypesMapObjects2<CObjectCloner>(CObjectCloner & s);
 
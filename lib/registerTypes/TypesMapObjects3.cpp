@@ -28,7 +28,9 @@
 #include "../serializer/BinaryDeserializer.h"
 #include "../serializer/BinarySerializer.h"
 #include "../serializer/CTypeList.h"
+#include "../serializer/CObjectCloner.h"
 
 template void registerTypesMapObjectTypes<BinaryDeserializer>(BinaryDeserializer & s);
 template void registerTypesMapObjectTypes<BinarySerializer>(BinarySerializer & s);
 template void registerTypesMapObjectTypes<CTypeList>(CTypeList & s);
+template void registerTypesMapObjectTypes<CObjectCloner>(CObjectCloner & s);
@@ -10,6 +10,9 @@
 #include "StdInc.h"
 #include "BinaryDeserializer.h"
 #include "../filesystem/FileStream.h"
+#include "../filesystem/CCompressedStream.h"
+#include "../filesystem/CFileInputStream.h"
+#include "BinarySerializer.h"
 
 #include "../registerTypes/RegisterTypes.h"
 
@@ -28,7 +31,13 @@ CLoadFile::~CLoadFile()
 
 int CLoadFile::read(void * data, unsigned size)
 {
-	sfile->read((char*)data,size);
+	if(compressedData)
+	{
+		if(compressedData->read(static_cast<ui8 *>(data), size) != size)
+			THROW_FORMAT("Error: unexpected end of compressed file %s!", fName);
+	}
+	else
+		sfile->read((char*)data,size);
 	return size;
 }
 
@@ -37,9 +46,12 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 	assert(!serializer.reverseEndianess);
 	assert(minimalVersion <= SERIALIZATION_VERSION);
 
+	CSaveFile::waitForBackgroundWrites(); //file may be still being written
+
 	try
 	{
 		fName = fname.string();
+		compressedData.reset();
 		sfile = make_unique<FileStream>(fname, std::ios::in | std::ios::binary);
 		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
 
@@ -72,6 +84,14 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 			else
 				THROW_FORMAT("Error: too new file format (%s)!", fName);
 		}
+
+		if(serializer.fileVersion >= 780)
+		{
+			ui8 compressed;
+			sfile->read(reinterpret_cast<char *>(&compressed), sizeof(compressed));
+			if(compressed)
+				compressedData = make_unique<CCompressedStream>(make_unique<CFileInputStream>(fname, sfile->tellg()), false);
+		}
 	}
 	catch(...)
 	{
@@ -89,6 +109,7 @@ void CLoadFile::reportState(vstd::CLoggerBase * out)
 
 void CLoadFile::clear()
 {
+	compressedData = nullptr;
 	sfile = nullptr;
 	fName.clear();
 	serializer.fileVersion = 0;
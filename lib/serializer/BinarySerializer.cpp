@@ -10,13 +10,73 @@
 #include "StdInc.h"
 #include "BinarySerializer.h"
 #include "../filesystem/FileStream.h"
+#include "../filesystem/CCompressedStream.h"
+#include "../CThreadHelper.h"
+#include "../CStopWatch.h"
 
 #include "../registerTypes/RegisterTypes.h"
 
 extern template void registerTypes<BinarySerializer>(BinarySerializer & s);
 
-CSaveFile::CSaveFile(const boost::filesystem::path &fname)
-	: serializer(this)
+static const size_t COMPRESSION_BLOCK_SIZE = 1 << 20;
+
+namespace
+{
+	/// Thread that finishes saves in background. Each save starts only after the previous one is written
+	class CBackgroundWriter
+	{
+		boost::mutex mx;
+		boost::thread lastWrite;
+
+	public:
+		void start(const std::function<void()> & write)
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			auto previous = std::make_shared<boost::thread>(std::move(lastWrite));
+			lastWrite = boost::thread([previous, write]()
+			{
+				if(previous->joinable())
+					previous->join();
+				write();
+			});
+		}
+
+		void wait()
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			if(lastWrite.joinable())
+				lastWrite.join();
+		}
+
+		~CBackgroundWriter()
+		{
+			wait(); //saves are not lost on exit
+		}
+	};
+
+	CBackgroundWriter & backgroundWriter()
+	{
+		static CBackgroundWriter writer;
+		return writer;
+	}
+
+	/// Unique for each writer, so saves to the same file from several threads or processes do not mix
+	boost::filesystem::path temporaryName(const boost::filesystem::path & target)
+	{
+		return boost::filesystem::unique_path(target.string() + ".%%%%-%%%%.tmp");
+	}
+
+	void writeHeader(std::ostream & out, bool compressed)
+	{
+		const ui8 compressionFlag = compressed;
+		out.write("VCMI", 4); //write magic identifier
+		out.write(reinterpret_cast<const char *>(&SERIALIZATION_VERSION), sizeof(SERIALIZATION_VERSION)); //write format version
+		out.write(reinterpret_cast<const char *>(&compressionFlag), sizeof(compressionFlag));
+	}
+}
+
+CSaveFile::CSaveFile(const boost::filesystem::path &fname, EMode mode)
+	: serializer(this), mode(mode)
 {
 	registerTypes(serializer);
 	openNextFile(fname);
@@ -24,27 +84,80 @@ CSaveFile::CSaveFile(const boost::filesystem::path &fname)
 
 CSaveFile::~CSaveFile()
 {
+	try
+	{
+		finishFile();
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to save to %s: %s", fName.string(), e.what());
+		clear();
+	}
 }
 
 int CSaveFile::write(const void * data, unsigned size)
 {
-	sfile->write((char *)data,size);
+	if(mode == UNCOMPRESSED)
+	{
+		sfile->write((char *)data,size);
+	}
+	else
+	{
+		auto bytes = static_cast<const ui8 *>(data);
+		buffer.insert(buffer.end(), bytes, bytes + size);
+		if(compressor && buffer.size() >= COMPRESSION_BLOCK_SIZE)
+			compressBuffer();
+	}
 	return size;
 }
 
+void CSaveFile::compressBuffer()
+{
+	compressor->write(buffer.data(), buffer.size());
+	buffer.clear();
+}
+
+void CSaveFile::finishFile()
+{
+	if(compressor)
+	{
+		compressBuffer();
+		compressor->finish();
+		compressor.reset();
+	}
+
+	if(!tempName.empty())
+	{
+		sfile->flush();
+		sfile.reset();
+		boost::filesystem::rename(tempName, fName);
+		tempName.clear();
+	}
+}
+
 void CSaveFile::openNextFile(const boost::filesystem::path &fname)
 {
+	finishFile();
+
 	fName = fname;
+	buffer.clear();
+	if(mode == BACKGROUND)
+		return; //file is created by finishInBackground()
+
 	try
 	{
-		sfile = make_unique<FileStream>(fname, std::ios::out | std::ios::binary);
+		if(mode == COMPRESSED)
+			tempName = temporaryName(fname);
+
+		sfile = make_unique<FileStream>(mode == COMPRESSED ? tempName : fname, std::ios::out | std::ios::binary);
 		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
 
 		if(!(*sfile))
 			THROW_FORMAT("Error: cannot open to write %s!", fname);
 
-		sfile->write("VCMI",4); //write magic identifier
-		serializer & SERIALIZATION_VERSION; //write format version
+		writeHeader(*sfile, mode == COMPRESSED);
+		if(mode == COMPRESSED)
+			compressor = make_unique<CStreamCompressor>(*sfile);
 	}
 	catch(...)
 	{
@@ -54,6 +167,55 @@ void CSaveFile::openNextFile(const boost::filesystem::path &fname)
 	}
 }
 
+void CSaveFile::finishInBackground(const std::function<void(bool)> & onWritten)
+{
+	assert(mode == BACKGROUND);
+
+	auto data = std::make_shared<std::vector<ui8>>();
+	data->swap(buffer);
+	const boost::filesystem::path target = fName;
+
+	backgroundWriter().start([data, target, onWritten]()
+	{
+		setThreadName("CSaveFile::finishInBackground");
+		CStopWatch timer;
+		const boost::filesystem::path tempFile = temporaryName(target);
+		bool written = false;
+		try
+		{
+			{
+				FileStream file(tempFile, std::ios::out | std::ios::binary);
+				file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+				if(!file)
+					THROW_FORMAT("Error: cannot open to write %s!", tempFile);
+
+				writeHeader(file, true);
+				CStreamCompressor compressor(file);
+				compressor.write(data->data(), data->size());
+				compressor.finish();
+			}
+			boost::filesystem::rename(tempFile, target);
+			logGlobal->info("Saved %s in background: %d KiB compressed to %d KiB in %d ms", target.string(),
+				data->size() / 1024, boost::filesystem::file_size(target) / 1024, timer.getDiff());
+			written = true;
+		}
+		catch(std::exception & e)
+		{
+			logGlobal->error("Failed to save to %s: %s", target.string(), e.what());
+			boost::system::error_code ec;
+			boost::filesystem::remove(tempFile, ec);
+		}
+
+		if(onWritten)
+			onWritten(written);
+	});
+}
+
+void CSaveFile::waitForBackgroundWrites()
+{
+	backgroundWriter().wait();
+}
+
 void CSaveFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CSaveFile");
@@ -65,8 +227,16 @@ void CSaveFile::reportState(vstd::CLoggerBase * out)
 
 void CSaveFile::clear()
 {
+	compressor.reset();
+	buffer.clear();
 	fName.clear();
 	sfile = nullptr;
+	if(!tempName.empty())
+	{
+		boost::system::error_code ec;
+		boost::filesystem::remove(tempName, ec); //unfinished file never replaces the target
+		tempName.clear();
+	}
 }
 
 void CSaveFile::putMagicBytes(const std::string &text)
@@ -13,6 +13,7 @@
 #include "../mapObjects/CArmedInstance.h"
 
 class FileStream;
+class CStreamCompressor;
 
 class DLL_LINKAGE CSaverBase
 {
@@ -346,15 +347,23 @@ public:
 	}
 };
 
+/// File consists of "VCMI" magic, format version and compression flag followed by serialized data
 class DLL_LINKAGE CSaveFile : public IBinaryWriter
 {
 public:
+	enum EMode
+	{
+		UNCOMPRESSED,
+		COMPRESSED, //data is compressed with zlib while being serialized, file replaces previous one once it is closed
+		BACKGROUND //compressed, but serialized data is kept in memory until finishInBackground() is called
+	};
+
 	BinarySerializer serializer;
 
 	boost::filesystem::path fName;
 	std::unique_ptr<FileStream> sfile;
 
-	CSaveFile(const boost::filesystem::path &fname); //throws!
+	CSaveFile(const boost::filesystem::path &fname, EMode mode = UNCOMPRESSED); //throws!
 	~CSaveFile();
 	int write(const void * data, unsigned size) override;
 
@@ -364,10 +373,26 @@ public:
 
 	void putMagicBytes(const std::string &text);
 
+	/// Only in BACKGROUND mode. Data serialized so far is compressed and written by background thread,
+	/// file replaces previous one only once it is complete. Nothing is written if this is never called
+	/// onWritten is called from background thread with result, after file is renamed or writing failed
+	void finishInBackground(const std::function<void(bool)> & onWritten = nullptr);
+	/// Blocks until all files finished in background are written
+	static void waitForBackgroundWrites();
+
 	template<class T>
 	CSaveFile & operator<<(const T &t)
 	{
 		serializer & t;
 		return * this;
 	}
+
+private:
+	EMode mode;
+	std::vector<ui8> buffer; //serialized data which was not compressed yet
+	std::unique_ptr<CStreamCompressor> compressor;
+	boost::filesystem::path tempName; //file being written in COMPRESSED mode, renamed to fName once finished
+
+	void compressBuffer();
+	void finishFile(); //throws!
 };
@@ -0,0 +1,38 @@
+/*
+ * CObjectCloner.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CObjectCloner.h"
+
+#include "../registerTypes/RegisterTypes.h"
+
+// only types that are part of game state, packs are never cloned
+extern template void registerTypesMapObjects1<CObjectCloner>(CObjectCloner & s);
+extern template void registerTypesMapObjects2<CObjectCloner>(CObjectCloner & s);
+extern template void registerTypesMapObjectTypes<CObjectCloner>(CObjectCloner & s);
+
+CApplier<CObjectCloner::CBasicPointerCloner> & CObjectCloner::getApplier()
+{
+	static CApplier<CBasicPointerCloner> applier;
+	return applier;
+}
+
+CObjectCloner::CObjectCloner()
+	: fields(nullptr), nextField(0), objectBegin(nullptr), objectEnd(nullptr),
+	saving(false), smartPointerSerialization(true), version(SERIALIZATION_VERSION)
+{
+	// unlike serializers cloners are created for every copy, so types are registered only once
+	static std::once_flag registered;
+	std::call_once(registered, [this]()
+	{
+		registerTypesMapObjects1(*this);
+		registerTypesMapObjects2(*this);
+		registerTypesMapObjectTypes(*this);
+	});
+}
@@ -0,0 +1,424 @@
+/*
+ * CObjectCloner.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "CTypeList.h"
+
+/// Performs deep object copies using serialize() methods of objects, without any intermediate buffer
+/// Result is same as of CMemorySerializer::deepCopy: pointers are followed, each pointed object is copied only once
+///
+/// Each object is copied in two passes. First serialize() runs on source as saving, which collects addresses of
+/// all serialized fields. Then serialize() runs on copy as loading and each field receives copy of matching source field.
+/// Values created by serialize() only for saving (e.g. IDs instead of pointers) are kept until copy is loaded.
+class DLL_LINKAGE CObjectCloner
+{
+	template <typename T, typename Enable = void>
+	struct ClassObjectCreator
+	{
+		static T * invoke()
+		{
+			static_assert(!std::is_abstract<T>::value, "Cannot call new upon abstract classes!");
+			return new T();
+		}
+	};
+
+	template<typename T>
+	struct ClassObjectCreator<T, typename std::enable_if<std::is_abstract<T>::value>::type>
+	{
+		static T * invoke()
+		{
+			throw std::runtime_error("Attempted cloning object of an abstract class " + std::string(typeid(T).name()));
+		}
+	};
+
+	template <typename T> class CPointerCloner;
+
+	class CBasicPointerCloner
+	{
+	public:
+		virtual void * clonePtr(CObjectCloner & cloner, const void * source) const = 0; //source points to the most derived object
+		virtual ~CBasicPointerCloner(){}
+
+		template<typename T> static CBasicPointerCloner * getApplier(const T * t = nullptr)
+		{
+			return new CPointerCloner<T>();
+		}
+	};
+
+	template <typename T> class CPointerCloner : public CBasicPointerCloner
+	{
+	public:
+		void * clonePtr(CObjectCloner & cloner, const void * source) const override
+		{
+			const T * src = static_cast<const T *>(source);
+			T * ptr = ClassObjectCreator<T>::invoke();
+			cloner.ptrCloned(source, ptr);
+			//T is most derived known type, it's time to copy its fields
+			cloner.cloneObject(*src, *ptr);
+			return ptr;
+		}
+	};
+
+	template<typename Variant>
+	struct VariantCloner : boost::static_visitor<>
+	{
+		CObjectCloner & cloner;
+		Variant & data;
+
+		VariantCloner(CObjectCloner & cloner, Variant & data):
+			cloner(cloner), data(data)
+		{
+		}
+
+		template<typename Type>
+		void operator()(const Type & source) const
+		{
+			Type obj;
+			cloner.clone(source, obj);
+			data = Variant(obj);
+		}
+	};
+
+	struct Field
+	{
+		const void * source;
+		std::shared_ptr<void> temporary; //owns source if it was created by serialize() while saving
+	};
+
+	/// types registered with registerTypes(), shared by all cloners
+	static CApplier<CBasicPointerCloner> & getApplier();
+
+	std::vector<Field> * fields; //fields of object that is being copied
+	size_t nextField;
+	const ui8 * objectBegin;
+	const ui8 * objectEnd;
+
+	std::map<const void *, std::pair<void *, const std::type_info *>> clonedPointers; //most derived source -> copy and its type
+	std::map<const void *, boost::any> clonedSharedPointers;
+
+	template <typename T, typename std::enable_if<std::is_copy_constructible<T>::value, int>::type = 0>
+	static std::shared_ptr<void> copyTemporary(const T & data)
+	{
+		return std::make_shared<T>(data);
+	}
+
+	template <typename T, typename std::enable_if<!std::is_copy_constructible<T>::value, int>::type = 0>
+	static std::shared_ptr<void> copyTemporary(const T & data)
+	{
+		throw std::runtime_error("Cannot clone temporary object of type " + std::string(typeid(T).name()));
+	}
+
+	template <typename T>
+	void recordField(const T & data)
+	{
+		const ui8 * address = reinterpret_cast<const ui8 *>(&data);
+		Field field;
+		if(address >= objectBegin && address < objectEnd)
+		{
+			field.source = &data;
+		}
+		else
+		{
+			field.temporary = copyTemporary(data);
+			field.source = field.temporary.get();
+		}
+		fields->push_back(std::move(field));
+	}
+
+	template <typename T>
+	void ptrCloned(const void * source, T * ptr)
+	{
+		clonedPointers[source] = std::make_pair(static_cast<void *>(ptr), &typeid(T));
+	}
+
+public:
+	bool saving;
+	bool smartPointerSerialization;
+	const int version;
+
+	CObjectCloner();
+
+	template<typename Base, typename Derived> void registerType(const Base * b = nullptr, const Derived * d = nullptr)
+	{
+		getApplier().registerType(b, d);
+	}
+
+	template<class T>
+	CObjectCloner & operator&(T & data)
+	{
+		if(saving)
+		{
+			recordField(data);
+		}
+		else
+		{
+			assert(nextField < fields->size());
+			const T & source = *static_cast<const T *>((*fields)[nextField++].source);
+			typedef typename std::remove_const<T>::type nonConstT;
+			clone(source, const_cast<nonConstT &>(data));
+		}
+		return *this;
+	}
+
+	template <typename T>
+	void cloneObject(const T & source, T & data)
+	{
+		std::vector<Field> objectFields;
+
+		auto outerFields = fields;
+		auto outerNextField = nextField;
+		auto outerBegin = objectBegin;
+		auto outerEnd = objectEnd;
+
+		fields = &objectFields;
+		objectBegin = reinterpret_cast<const ui8 *>(&source);
+		objectEnd = objectBegin + sizeof(T);
+
+		saving = true;
+		const_cast<T &>(source).serialize(*this, version);
+
+		saving = false;
+		nextField = 0;
+		data.serialize(*this, version);
+		assert(nextField == objectFields.size());
+
+		fields = outerFields;
+		nextField = outerNextField;
+		objectBegin = outerBegin;
+		objectEnd = outerEnd;
+	}
+
+	template < class T, typename std::enable_if < std::is_fundamental<T>::value || std::is_enum<T>::value, int >::type = 0 >
+	void clone(const T & source, T & data)
+	{
+		data = source;
+	}
+
+	template < typename T, typename std::enable_if < is_serializeable<CObjectCloner, T>::value, int >::type = 0 >
+	void clone(const T & source, T & data)
+	{
+		cloneObject(source, data);
+	}
+
+	template < typename T, typename std::enable_if < std::is_array<T>::value, int >::type = 0 >
+	void clone(const T & source, T & data)
+	{
+		for(ui32 i = 0; i < ARRAY_COUNT(data); i++)
+			clone(source[i], data[i]);
+	}
+
+	template < typename T, typename std::enable_if < std::is_same<T, std::vector<bool> >::value, int >::type = 0 >
+	void clone(const T & source, T & data)
+	{
+		data = source;
+	}
+
+	template <typename T, typename std::enable_if < !std::is_same<T, bool >::value, int >::type = 0>
+	void clone(const std::vector<T> & source, std::vector<T> & data)
+	{
+		data.resize(source.size());
+		for(size_t i = 0; i < source.size(); i++)
+			clone(source[i], data[i]);
+	}
+
+	template < typename T, typename std::enable_if < std::is_pointer<T>::value, int >::type = 0 >
+	void clone(const T & source, T & data)
+	{
+		typedef typename std::remove_const<typename std::remove_pointer<T>::type>::type ncpT;
+
+		if(!source)
+		{
+			data = nullptr;
+			return;
+		}
+
+		// We might have an object that has multiple inheritance and is stored via the non-first base pointer.
+		// Therefore, all pointers need to be normalized to the actual object address.
+		const void * actualSource = typeList.castToMostDerived(source);
+		auto i = clonedPointers.find(actualSource);
+		if(i != clonedPointers.end())
+		{
+			data = reinterpret_cast<T>(typeList.castRaw(i->second.first, i->second.second, &typeid(ncpT)));
+			return;
+		}
+
+		ui16 tid = typeList.getTypeID(source);
+		if(!tid)
+		{
+			ncpT * ptr = ClassObjectCreator<ncpT>::invoke();
+			ptrCloned(actualSource, ptr);
+			clone(*source, *ptr);
+			data = ptr;
+		}
+		else
+		{
+			void * ptr = getApplier().getApplier(tid)->clonePtr(*this, actualSource);
+			data = reinterpret_cast<T>(typeList.castRaw(ptr, typeList.getTypeInfo(source), &typeid(ncpT)));
+		}
+	}
+
+	template <typename T>
+	void clone(const std::shared_ptr<T> & source, std::shared_ptr<T> & data)
+	{
+		typedef typename std::remove_const<T>::type NonConstT;
+
+		if(!source)
+		{
+			data.reset();
+			return;
+		}
+
+		NonConstT * internalPtr;
+		clone(const_cast<NonConstT *>(source.get()), internalPtr);
+
+		void * internalPtrDerived = typeList.castToMostDerived(internalPtr);
+		auto itr = clonedSharedPointers.find(internalPtrDerived);
+		if(itr != clonedSharedPointers.end())
+		{
+			// This object is already owned by other shared pointer, share its state
+			auto actualType = typeList.getTypeInfo(internalPtr);
+			auto typeWeNeedToReturn = typeList.getTypeInfo<T>();
+			if(*actualType == *typeWeNeedToReturn)
+				data = boost::any_cast<std::shared_ptr<T>>(itr->second);
+			else
+				data = boost::any_cast<std::shared_ptr<T>>(typeList.castShared(itr->second, actualType, typeWeNeedToReturn));
+		}
+		else
+		{
+			auto hlp = std::shared_ptr<NonConstT>(internalPtr);
+			data = hlp;
+			clonedSharedPointers[internalPtrDerived] = typeList.castSharedToMostDerived(hlp);
+		}
+	}
+
+	template <typename T>
+	void clone(const std::unique_ptr<T> & source, std::unique_ptr<T> & data)
+	{
+		T * internalPtr;
+		clone(source.get(), internalPtr);
+		data.reset(internalPtr);
+	}
+
+	template <typename T, size_t N>
+	void clone(const std::array<T, N> & source, std::array<T, N> & data)
+	{
+		for(ui32 i = 0; i < N; i++)
+			clone(source[i], data[i]);
+	}
+
+	template <typename T>
+	void clone(const std::set<T> & source, std::set<T> & data)
+	{
+		data.clear();
+		for(const T & item : source)
+		{
+			T ins;
+			clone(item, ins);
+			data.insert(ins);
+		}
+	}
+
+	template <typename T, typename U>
+	void clone(const std::unordered_set<T, U> & source, std::unordered_set<T, U> & data)
+	{
+		data.clear();
+		for(const T & item : source)
+		{
+			T ins;
+			clone(item, ins);
+			data.insert(ins);
+		}
+	}
+
+	template <typename T>
+	void clone(const std::list<T> & source, std::list<T> & data)
+	{
+		data.clear();
+		for(const T & item : source)
+		{
+			data.push_back(T());
+			clone(item, data.back());
+		}
+	}
+
+	template <typename T1, typename T2>
+	void clone(const std::pair<T1, T2> & source, std::pair<T1, T2> & data)
+	{
+		clone(source.first, data.first);
+		clone(source.second, data.second);
+	}
+
+	template <typename T1, typename T2>
+	void clone(const std::map<T1, T2> & source, std::map<T1, T2> & data)
+	{
+		data.clear();
+		for(const auto & item : source)
+		{
+			T1 key;
+			T2 value;
+			clone(item.first, key);
+			clone(item.second, value);
+			data.insert(std::pair<T1, T2>(std::move(key), std::move(value)));
+		}
+	}
+
+	template <typename T1, typename T2>
+	void clone(const std::multimap<T1, T2> & source, std::multimap<T1, T2> & data)
+	{
+		data.clear();
+		for(const auto & item : source)
+		{
+			T1 key;
+			T2 value;
+			clone(item.first, key);
+			clone(item.second, value);
+			data.insert(std::pair<T1, T2>(std::move(key), std::move(value)));
+		}
+	}
+
+	void clone(const std::string & source, std::string & data)
+	{
+		data = source;
+	}
+
+	template <BOOST_VARIANT_ENUM_PARAMS(typename T)>
+	void clone(const boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)> & source, boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)> & data)
+	{
+		typedef boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)> TVariant;
+
+		VariantCloner<TVariant> cloner(*this, data);
+		boost::apply_visitor(cloner, source);
+	}
+
+	template <typename T>
+	void clone(const boost::optional<T> & source, boost::optional<T> & data)
+	{
+		if(source)
+		{
+			T t;
+			clone(*source, t);
+			data = boost::make_optional(std::move(t));
+		}
+		else
+		{
+			data = boost::optional<T>();
+		}
+	}
+
+	template <typename T>
+	static std::unique_ptr<T> deepCopy(const T & data)
+	{
+		CObjectCloner cloner;
+
+		T * ret;
+		cloner.clone(const_cast<T *>(&data), ret);
+		return std::unique_ptr<T>(ret);
+	}
+};
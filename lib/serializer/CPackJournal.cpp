@@ -0,0 +1,91 @@
+/*
+ * CPackJournal.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CPackJournal.h"
+
+#include "BinarySerializer.h"
+#include "BinaryDeserializer.h"
+#include "../filesystem/FileStream.h"
+#include "../CGameState.h"
+#include "../IGameCallback.h"
+#include "../NetPacksBase.h"
+
+static const std::string JOURNAL_MAGIC = "VCMIJournal";
+
+CPackJournal::CPackJournal(const boost::filesystem::path & fname, const CPrivilagedInfoCallback & base)
+	: file(make_unique<CSaveFile>(fname)), packs(0)
+{
+	base.saveCommonState(*file);
+	file->putMagicBytes(JOURNAL_MAGIC);
+	file->sfile->flush();
+}
+
+CPackJournal::~CPackJournal() = default;
+
+void CPackJournal::append(const std::vector<ui8> & pack)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	// size goes first, so pack that was not written completely can be recognized and skipped
+	ui32 length = pack.size();
+	*file << length;
+	file->write(pack.data(), length);
+	file->sfile->flush();
+	packs++;
+}
+
+ui32 CPackJournal::size() const
+{
+	return packs;
+}
+
+ui32 CPackJournal::replay(const boost::filesystem::path & fname, CPrivilagedInfoCallback & state)
+{
+	const auto fileSize = boost::filesystem::file_size(fname);
+
+	CLoadFile load(fname);
+	if(load.compressedData)
+		throw std::runtime_error("Journal " + fname.string() + " is compressed");
+
+	state.loadCommonState(load);
+	load.checkMagicBytes(JOURNAL_MAGIC);
+
+	// same settings as connections to clients use
+	CGameState * gs = state.gameState();
+	load.addStdVecItems(gs);
+	load.sendStackInstanceByIds = true;
+	load.serializer.smartPointerSerialization = false;
+
+	ui32 applied = 0;
+	while(true)
+	{
+		const ui64 position = load.sfile->tellg();
+		if(position + sizeof(ui32) > fileSize)
+			break;
+
+		ui32 length;
+		load >> length;
+		if(position + sizeof(ui32) + length > fileSize)
+		{
+			logGlobal->warn("Journal %s ends with incomplete pack, it is ignored", fname.string());
+			break;
+		}
+
+		CPack * pack = nullptr;
+		load >> pack;
+		std::unique_ptr<CPack> owner(pack);
+		if(static_cast<ui64>(load.sfile->tellg()) != position + sizeof(ui32) + length)
+			throw std::runtime_error(boost::str(boost::format("Journal %s is corrupted at pack %d") % fname.string() % applied));
+
+		gs->apply(pack);
+		applied++;
+	}
+	return applied;
+}
@@ -0,0 +1,37 @@
+/*
+ * CPackJournal.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+class CSaveFile;
+class CPrivilagedInfoCallback;
+
+/// Append-only record of packs applied to game state
+/// File starts with base snapshot of game, as written by CPrivilagedInfoCallback::saveCommonState,
+/// followed by packs in order in which they were applied. Packs are stored in the same form as they are
+/// sent to clients (vectorized members, stacks by IDs) and are read against state from before they were applied.
+class DLL_LINKAGE CPackJournal : boost::noncopyable
+{
+	std::unique_ptr<CSaveFile> file;
+	boost::mutex mx;
+	ui32 packs;
+
+public:
+	/// Creates new journal, current state of game becomes its base snapshot
+	CPackJournal(const boost::filesystem::path & fname, const CPrivilagedInfoCallback & base); //throws!
+	~CPackJournal();
+
+	/// Appends serialized pack, file is flushed so journal remains usable if game ends unexpectedly
+	void append(const std::vector<ui8> & pack);
+	ui32 size() const;
+
+	/// Loads base snapshot into state (which takes ownership of loaded game state) and applies all complete
+	/// packs recorded after it. Returns number of applied packs
+	static ui32 replay(const boost::filesystem::path & fname, CPrivilagedInfoCallback & state); //throws!
+};
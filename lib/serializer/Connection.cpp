@@ -19,6 +19,9 @@
 using namespace boost;
 using namespace boost::asio::ip;
 
+static const size_t READ_BUFFER_SIZE = 64 * 1024;
+static const size_t WRITE_BUFFER_LIMIT = 1024 * 1024; //bigger objects are sent in parts to limit memory usage
+
 #if defined(__hppa__) || \
 	defined(__m68k__) || defined(mc68000) || defined(_M_M68K) || \
 	(defined(__MIPS__) && defined(__MISPEB__)) || \
@@ -34,6 +37,8 @@ void CConnection::init()
 {
 	boost::asio::ip::tcp::no_delay option(true);
 	socket->set_option(option);
+	readBuffer.resize(READ_BUFFER_SIZE);
+	readPos = readEnd = 0;
 
 	enableSmartPointerSerialization();
 	disableStackSendingByID();
@@ -48,6 +53,7 @@ void CConnection::init()
 	std::string pom;
 	//we got connection
 	oser & std::string("Aiya!\n") & name & myEndianess; //identify ourselves
+	flush();
 	iser & pom & pom & contactEndianess;
 	logNetwork->info("Established connection with %s", pom);
 	wmx = new boost::mutex();
@@ -136,15 +142,26 @@ CConnection::CConnection(TAcceptor * acceptor, boost::asio::io_service *Io_servi
 }
 int CConnection::write(const void * data, unsigned size)
 {
+	auto bytes = static_cast<const ui8 *>(data);
+	writeBuffer.insert(writeBuffer.end(), bytes, bytes + size);
+	if(writeBuffer.size() >= WRITE_BUFFER_LIMIT)
+		flush();
+	return size;
+}
+void CConnection::flush()
+{
+	if(writeBuffer.empty())
+		return;
+
 	try
 	{
-		int ret;
-		ret = asio::write(*socket,asio::const_buffers_1(asio::const_buffer(data,size)));
-		return ret;
+		asio::write(*socket, asio::buffer(writeBuffer));
+		writeBuffer.clear();
 	}
 	catch(...)
 	{
 		//connection has been lost
+		writeBuffer.clear();
 		connected = false;
 		throw;
 	}
@@ -153,8 +170,29 @@ int CConnection::read(void * data, unsigned size)
 {
 	try
 	{
-		int ret = asio::read(*socket,asio::mutable_buffers_1(asio::mutable_buffer(data,size)));
-		return ret;
+		auto bytes = static_cast<ui8 *>(data);
+		unsigned left = size;
+		while(left)
+		{
+			if(readPos == readEnd)
+			{
+				if(left >= READ_BUFFER_SIZE)
+				{
+					asio::read(*socket, asio::buffer(bytes, left));
+					return size;
+				}
+				//take everything that already arrived, not only requested part
+				readEnd = socket->read_some(asio::buffer(readBuffer));
+				readPos = 0;
+			}
+
+			const size_t chunk = std::min<size_t>(left, readEnd - readPos);
+			std::copy(readBuffer.begin() + readPos, readBuffer.begin() + readPos + chunk, bytes);
+			readPos += chunk;
+			bytes += chunk;
+			left -= chunk;
+		}
+		return size;
 	}
 	catch(...)
 	{
@@ -210,7 +248,7 @@ void CConnection::reportState(vstd::CLoggerBase * out)
 	if(socket && socket->is_open())
 	{
 		out->debug("\tWe have an open and valid socket");
-		out->debug("\t %d bytes awaiting", socket->available());
+		out->debug("\t %d bytes awaiting", socket->available() + readEnd - readPos);
 	}
 }
 
@@ -229,6 +267,23 @@ void CConnection::sendPackToServer(const CPack &pack, PlayerColor player, ui32 r
 	boost::unique_lock<boost::mutex> lock(*wmx);
 	logNetwork->trace("Sending to server a pack of type %s", typeid(pack).name());
 	oser & player & requestID & &pack; //packs has to be sent as polymorphic pointers!
+	flush();
+}
+
+void CConnection::sendBuffer(const std::vector<ui8> & data)
+{
+	assert(!oser.smartPointerSerialization);
+	flush();
+	try
+	{
+		asio::write(*socket, asio::buffer(data));
+	}
+	catch(...)
+	{
+		//connection has been lost
+		connected = false;
+		throw;
+	}
 }
 
 void CConnection::disableStackSendingByID()
@@ -284,3 +339,27 @@ std::string CConnection::toString() const
     fmt % name % connectionID;
     return fmt.str();
 }
+
+CConnectionBuffer::CConnectionBuffer()
+	: oser(this)
+{
+	registerTypes(oser);
+	oser.smartPointerSerialization = false;
+}
+
+int CConnectionBuffer::write(const void * data, unsigned size)
+{
+	auto bytes = static_cast<const ui8 *>(data);
+	buffer.insert(buffer.end(), bytes, bytes + size);
+	return size;
+}
+
+const std::vector<ui8> & CConnectionBuffer::getData() const
+{
+	return buffer;
+}
+
+void CConnectionBuffer::clear()
+{
+	buffer.clear();
+}
@@ -50,6 +50,11 @@ class DLL_LINKAGE CConnection
 
 	int write(const void * data, unsigned size) override;
 	int read(void * data, unsigned size) override;
+
+	/// Serializers write and read every value separately, so socket is accessed in blocks to avoid system call per value
+	std::vector<ui8> writeBuffer; //data not sent yet, see flush
+	std::vector<ui8> readBuffer;
+	size_t readPos, readEnd; //received bytes of readBuffer that weren't passed to reader yet
 public:
 	BinaryDeserializer iser;
 	BinarySerializer oser;
@@ -79,6 +84,8 @@ public:
 
 	CPack *retreivePack(); //gets from server next pack (allocates it with new)
 	void sendPackToServer(const CPack &pack, PlayerColor player, ui32 requestID);
+	void sendBuffer(const std::vector<ui8> & data); //sends data serialized by CConnectionBuffer, has to match serialization mode of this connection
+	void flush(); //sends all written data, done automatically after each sent object
 
 	void disableStackSendingByID();
 	void enableStackSendingByID();
@@ -103,6 +110,24 @@ public:
 	CConnection & operator<<(const T &t)
 	{
 		oser & t;
+		flush();
 		return * this;
 	}
 };
+
+/// Serializes objects into memory the same way as CConnection without smart pointer serialization does
+/// Allows encoding pack only once when it has to be sent to several connections
+class DLL_LINKAGE CConnectionBuffer
+	: public IBinaryWriter
+{
+	std::vector<ui8> buffer;
+
+	int write(const void * data, unsigned size) override;
+public:
+	BinarySerializer oser;
+
+	CConnectionBuffer();
+
+	const std::vector<ui8> & getData() const;
+	void clear();
+};
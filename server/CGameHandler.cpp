@@ -42,6 +42,7 @@
 #include "../lib/registerTypes/RegisterTypes.h"
 #include "../lib/serializer/CTypeList.h"
 #include "../lib/serializer/Connection.h"
+#include "../lib/serializer/CPackJournal.h"
 
 #ifndef _MSC_VER
 #include <boost/thread/xtime.hpp>
@@ -1106,6 +1107,7 @@ void CGameHandler::handleConnection(std::set<PlayerColor> players, CConnection &
 						% typeid(*pack).name()).str());
 
 				sendPackageResponse(true);
+				sendPendingMessages();
 			}
 			else
 			{
@@ -1406,6 +1408,7 @@ CGameHandler::CGameHandler()
 	IObjectInterface::cb = this;
 	applier = new CApplier<CBaseForGHApply>();
 	registerTypesServerPacks(*applier);
+	packBuffer = make_unique<CConnectionBuffer>();
 	visitObjectAfterVictory = false;
 
 	spellEnv = new ServerSpellCastEnvironment(this);
@@ -1413,6 +1416,7 @@ CGameHandler::CGameHandler()
 
 CGameHandler::~CGameHandler()
 {
+	CSaveFile::waitForBackgroundWrites(); //they report their result through this handler
 	delete spellEnv;
 	delete applier;
 	applier = nullptr;
@@ -1718,10 +1722,11 @@ void CGameHandler::newTurn()
 				fw.player = player;
 				// find all hidden tiles
 				const auto & fow = getPlayerTeam(player)->fogOfWarMap;
-				for (size_t i=0; i<fow.size(); i++)
-					for (size_t j=0; j<fow.at(i).size(); j++)
-						for (size_t k=0; k<fow.at(i).at(j).size(); k++)
-							if (!fow.at(i).at(j).at(k))
+				const int3 sizes = fow.getSizes();
+				for (int i=0; i<sizes.x; i++)
+					for (int j=0; j<sizes.y; j++)
+						for (int k=0; k<sizes.z; k++)
+							if (!fow.isVisible(int3(i,j,k)))
 								fw.tiles.insert(int3(i,j,k));
 
 				sendAndApply (&fw);
@@ -1846,6 +1851,24 @@ void CGameHandler::run(bool resume)
 		cc->disableSmartPointerSerialization();
 	}
 
+	// shared buffer has to encode packs exactly as connections above would
+	packBuffer->addStdVecItems(gs);
+	packBuffer->sendStackInstanceByIds = true;
+
+	if(cmdLineOptions.count("journal"))
+	{
+		const boost::filesystem::path journalPath = cmdLineOptions["journal"].as<std::string>();
+		try
+		{
+			logGlobal->info("Recording applied packs into %s", journalPath.string());
+			journal = make_unique<CPackJournal>(journalPath, *this);
+		}
+		catch(std::exception & e)
+		{
+			logGlobal->error("Failed to start journal %s: %s", journalPath.string(), e.what());
+		}
+	}
+
 	for (auto & elem : conns)
 	{
 		std::set<PlayerColor> pom;
@@ -1903,6 +1926,7 @@ void CGameHandler::run(bool resume)
 					{
 						static time_duration p = milliseconds(100);
 						states.cv.timed_wait(lock, p);
+						sendPendingMessages();
 					}
 				}
 			}
@@ -2602,28 +2626,67 @@ void CGameHandler::heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)
 }
 
 void CGameHandler::sendToAllClients(CPackForClient * info)
+{
+	std::vector<ui8> data;
+	sendToAllClients(info, data);
+}
+
+std::vector<ui8> CGameHandler::serializePack(CPackForClient * info)
+{
+	// copy is taken so other thread may serialize its pack while this one is still sending
+	boost::unique_lock<boost::mutex> bufferLock(packBufferMx);
+	packBuffer->clear();
+	packBuffer->oser & info;
+	return packBuffer->getData();
+}
+
+void CGameHandler::sendToAllClients(CPackForClient * info, std::vector<ui8> & data)
 {
 	logNetwork->trace("Sending to all clients a package of type %s", typeid(*info).name());
+
+	// pack is serialized once, only connection that remembers already sent pointers has to encode it on its own
 	for (auto & elem : conns)
 	{
 		if(!elem->isOpen())
 			continue;
 
 		boost::unique_lock<boost::mutex> lock(*(elem)->wmx);
-		*elem << info;
+		if(elem->oser.smartPointerSerialization)
+		{
+			*elem << info;
+			continue;
+		}
+
+		if(data.empty())
+			data = serializePack(info);
+		elem->sendBuffer(data);
 	}
 }
 
+void CGameHandler::recordPack(CPackForClient * info, std::vector<ui8> & data)
+{
+	if(!journal)
+		return;
+
+	if(data.empty())
+		data = serializePack(info);
+	journal->append(data);
+}
+
 void CGameHandler::sendAndApply(CPackForClient * info)
 {
-	sendToAllClients(info);
+	std::vector<ui8> data;
+	sendToAllClients(info, data);
+	recordPack(info, data);
 	gs->apply(info);
 }
 
 void CGameHandler::applyAndSend(CPackForClient * info)
 {
 	gs->apply(info);
-	sendToAllClients(info);
+	std::vector<ui8> data;
+	sendToAllClients(info, data);
+	recordPack(info, data);
 }
 
 void CGameHandler::sendAndApply(CGarrisonOperationPack * info)
@@ -2660,12 +2723,24 @@ void CGameHandler::save(const std::string & filename)
 	try
 	{
 		{
-			CSaveFile save(*CResourceHandler::get("local")->getResourceName(ResourceID(stem.to_string(), EResType::SERVER_SAVEGAME)));
+			CSaveFile save(*CResourceHandler::get("local")->getResourceName(ResourceID(stem.to_string(), EResType::SERVER_SAVEGAME)), CSaveFile::BACKGROUND);
 			saveCommonState(save);
 			logGlobal->info("Saving server state");
 			save << *this;
+			//game continues while save is compressed and written, players learn only about failure
+			save.finishInBackground([this, savefname](bool written)
+			{
+				if(written)
+				{
+					logGlobal->info("Game state has been successfully saved!");
+				}
+				else
+				{
+					logGlobal->error("Failed to write saved game %s", savefname);
+					postMessageToAll("Failed to save game " + savefname + "!");
+				}
+			});
 		}
-		logGlobal->info("Game has been successfully saved!");
 	}
 	catch(std::exception &e)
 	{
@@ -3073,6 +3148,23 @@ void CGameHandler::sendMessageToAll(const std::string &message)
 	sendToAllClients(&sm);
 }
 
+void CGameHandler::postMessageToAll(const std::string &message)
+{
+	boost::unique_lock<boost::mutex> lock(pendingMessagesMx);
+	pendingMessages.push_back(message);
+}
+
+void CGameHandler::sendPendingMessages()
+{
+	std::vector<std::string> messages;
+	{
+		boost::unique_lock<boost::mutex> lock(pendingMessagesMx);
+		messages.swap(pendingMessages);
+	}
+	for(auto & message : messages)
+		sendMessageToAll(message);
+}
+
 bool CGameHandler::recruitCreatures(ObjectInstanceID objid, ObjectInstanceID dstid, CreatureID crid, ui32 cram, si32 fromLvl)
 {
 	const CGDwelling * dw = static_cast<const CGDwelling *>(getObj(objid));
@@ -6317,7 +6409,7 @@ void CGameHandler::handleCheatCode(std::string & cheat, PlayerColor player, cons
 		for (int i = 0; i < gs->map->width; i++)
 			for (int j = 0; j < gs->map->height; j++)
 				for (int k = 0; k < (gs->map->twoLevel ? 2 : 1); k++)
-					if (!fowMap.at(i).at(j).at(k) || !fc.mode)
+					if (!fowMap.isVisible(int3(i, j, k)) || !fc.mode)
 						hlp_tab[lastUnc++] = int3(i, j, k);
 		fc.tiles.insert(hlp_tab, hlp_tab + lastUnc);
 		delete [] hlp_tab;
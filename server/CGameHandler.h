@@ -27,6 +27,8 @@ struct SetResources;
 struct NewStructures;
 class CGHeroInstance;
 class IMarket;
+class CConnectionBuffer;
+class CPackJournal;
 
 class SpellCastEnvironment;
 
@@ -83,6 +85,11 @@ public:
 	std::map<PlayerColor, CConnection*> connections; //player color -> connection to client with interface of that player
 	PlayerStatuses states; //player color -> player state
 	std::set<CConnection*> conns;
+	std::unique_ptr<CConnectionBuffer> packBuffer; //packs sent to all clients are serialized once into it
+	boost::mutex packBufferMx;
+	std::unique_ptr<CPackJournal> journal; //packs applied to game state, recorded only if server was started with --journal
+	std::vector<std::string> pendingMessages; //messages from background threads, sent to all clients by threads handling the game
+	boost::mutex pendingMessagesMx;
 
 	//queries stuff
 	boost::recursive_mutex gsm;
@@ -245,6 +252,8 @@ public:
 	}
 
 	void sendMessageToAll(const std::string &message);
+	void postMessageToAll(const std::string &message); //may be called from any thread, message is sent by next sendPendingMessages
+	void sendPendingMessages();
 	void sendMessageTo(CConnection &c, const std::string &message);
 	void sendToAllClients(CPackForClient * info);
 	void sendAndApply(CPackForClient * info) override;
@@ -303,6 +312,10 @@ private:
 	void checkVictoryLossConditionsForPlayer(PlayerColor player);
 	void checkVictoryLossConditions(const std::set<PlayerColor> & playerColors);
 	void checkVictoryLossConditionsForAll();
+
+	std::vector<ui8> serializePack(CPackForClient * info);
+	void sendToAllClients(CPackForClient * info, std::vector<ui8> & data); //data is filled if pack had to be serialized into packBuffer
+	void recordPack(CPackForClient * info, std::vector<ui8> & data);
 };
 
 class clientDisconnectedException : public std::exception
@@ -41,6 +41,8 @@
 #include "../lib/logging/CBasicLogConfigurator.h"
 #include "../lib/CConfigHandler.h"
 #include "../lib/ScopeGuard.h"
+#include "../lib/CStopWatch.h"
+#include "../lib/serializer/CPackJournal.h"
 
 #include "../lib/UnlockGuard.h"
 
@@ -531,6 +533,22 @@ void CVCMIServer::loadGame()
 
 
 
+static void replayJournal(const boost::filesystem::path & journalPath)
+{
+	logGlobal->info("Replaying journal %s", journalPath.string());
+	try
+	{
+		CGameHandler gh;
+		CStopWatch timer;
+		const ui32 packs = CPackJournal::replay(journalPath, gh);
+		logGlobal->info("Replayed %d packs in %d ms", packs, timer.getDiff());
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to replay journal %s: %s", journalPath.string(), e.what());
+	}
+}
+
 static void handleCommandOptions(int argc, char *argv[])
 {
 	namespace po = boost::program_options;
@@ -542,7 +560,9 @@ static void handleCommandOptions(int argc, char *argv[])
 		("uuid", po::value<std::string>(), "")
 		("enable-shm-uuid", "use UUID for shared memory identifier")
 		("enable-shm", "enable usage of shared memory")
-		("port", po::value<ui16>(), "port at which server will listen to connections from client");
+		("port", po::value<ui16>(), "port at which server will listen to connections from client")
+		("journal", po::value<std::string>(), "record packs applied to game state into given file")
+		("replay", po::value<std::string>(), "rebuild game state from journal recorded with --journal, report time and exit");
 
 	if(argc > 1)
 	{
@@ -628,36 +648,43 @@ int main(int argc, char * argv[])
 
 	loadDLLClasses();
 	srand ( (ui32)time(nullptr) );
-	try
+	if(cmdLineOptions.count("replay"))
+	{
+		replayJournal(cmdLineOptions["replay"].as<std::string>());
+	}
+	else
 	{
-		boost::asio::io_service io_service;
-		CVCMIServer server;
-
 		try
 		{
-			while(!serverShuttingDown)
+			boost::asio::io_service io_service;
+			CVCMIServer server;
+
+			try
 			{
-				server.start();
+				while(!serverShuttingDown)
+				{
+					server.start();
+				}
+				io_service.run();
+			}
+			catch (boost::system::system_error &e) //for boost errors just log, not crash - probably client shut down connection
+			{
+				logNetwork->error(e.what());
+				serverShuttingDown = true;
+			}
+			catch (...)
+			{
+				handleException();
 			}
-			io_service.run();
 		}
-		catch (boost::system::system_error &e) //for boost errors just log, not crash - probably client shut down connection
+		catch(boost::system::system_error &e)
 		{
 			logNetwork->error(e.what());
-			serverShuttingDown = true;
-		}
-		catch (...)
-		{
-			handleException();
+			//catch any startup errors (e.g. can't access port) errors
+			//and return non-zero status so client can detect error
+			throw;
 		}
 	}
-	catch(boost::system::system_error &e)
-	{
-		logNetwork->error(e.what());
-		//catch any startup errors (e.g. can't access port) errors
-		//and return non-zero status so client can detect error
-		throw;
-	}
 #ifdef VCMI_ANDROID
 	CAndroidVMHelper envHelper;
 	envHelper.callStaticVoidMethod(CAndroidVMHelper::NATIVE_METHODS_DEFAULT_CLASS, "killServer");
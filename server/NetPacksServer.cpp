@@ -82,7 +82,7 @@ CGameState * CPackForServer::GS(CGameHandler * gh)
 bool SaveGame::applyGh(CGameHandler * gh)
 {
 	gh->save(fname);
-	logGlobal->info("Game has been saved as %s", fname);
+	logGlobal->info("Game is being saved as %s", fname);
 	return true;
 }
 
@@ -0,0 +1,84 @@
+/*
+ * CFogOfWarMapTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/CFogOfWarMap.h"
+
+static const int3 TEST_MAP_SIZES(130, 70, 2);
+
+TEST(CFogOfWarMapTest, revealMatchesDistanceFormula)
+{
+	const std::vector<int3> centers = {int3(0, 0, 0), int3(63, 35, 1), int3(64, 10, 0), int3(129, 69, 1), int3(-3, 72, 0)};
+
+	for(auto formula : {int3::DIST_2D, int3::DIST_MANHATTAN, int3::DIST_CHEBYSHEV, int3::DIST_2DSQ})
+	{
+		for(int radius = 0; radius <= 70; radius += 7)
+		{
+			for(const int3 & center : centers)
+			{
+				CFogOfWarMap fow;
+				fow.resize(TEST_MAP_SIZES);
+				fow.reveal(center, radius, formula);
+
+				for(int x = 0; x < TEST_MAP_SIZES.x; x++)
+				{
+					for(int y = 0; y < TEST_MAP_SIZES.y; y++)
+					{
+						for(int z = 0; z < TEST_MAP_SIZES.z; z++)
+						{
+							const int3 tile(x, y, z);
+							const bool expected = z == center.z && center.dist(tile, formula) <= static_cast<ui32>(radius);
+							ASSERT_EQ(expected, fow.isVisible(tile)) << "formula " << formula << " radius " << radius << " center " << center.toString() << " tile " << tile.toString();
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST(CFogOfWarMapTest, revealEntireMap)
+{
+	CFogOfWarMap fow;
+	fow.resize(TEST_MAP_SIZES);
+	fow.reveal(int3(5, 5, 0), -1);
+
+	CFogOfWarMap expected;
+	expected.resize(TEST_MAP_SIZES);
+	for(int x = 0; x < TEST_MAP_SIZES.x; x++)
+		for(int y = 0; y < TEST_MAP_SIZES.y; y++)
+			for(int z = 0; z < TEST_MAP_SIZES.z; z++)
+				expected.setVisible(int3(x, y, z), true);
+
+	EXPECT_TRUE(expected == fow);
+
+	fow.setVisible(int3(64, 3, 1), false);
+	EXPECT_FALSE(fow.isVisible(int3(64, 3, 1)));
+	EXPECT_TRUE(fow.isVisible(int3(63, 3, 1)));
+	EXPECT_TRUE(fow.isVisible(int3(65, 3, 1)));
+	EXPECT_FALSE(expected == fow);
+}
+
+TEST(CFogOfWarMapTest, tileRunsKeepAllTiles)
+{
+	std::unordered_set<int3, ShashInt3> tiles;
+	for(int y = 0; y < 20; y++)
+		for(int x = y; x < 2 * y + 3; x++)
+			tiles.insert(int3(x, y, y % 2));
+	tiles.insert(int3(100, 0, 0));
+	tiles.insert(int3(102, 0, 0));
+
+	const std::vector<TileRun> runs = TileRun::fromTiles(tiles);
+	EXPECT_EQ(22, runs.size());
+
+	std::unordered_set<int3, ShashInt3> decoded;
+	TileRun::toTiles(runs, decoded);
+	EXPECT_EQ(tiles, decoded);
+}
@@ -0,0 +1,126 @@
+/*
+ * CThreadPoolTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CThreadHelper.h"
+
+struct CThreadPoolTest : testing::Test
+{
+	CThreadPool subject;
+
+	CThreadPoolTest()
+		: subject(4)
+	{
+	}
+};
+
+TEST_F(CThreadPoolTest, parallelForVisitsEachIndexOnce)
+{
+	std::vector<std::atomic<int>> visits(1000);
+	for(auto & visit : visits)
+		visit = 0;
+
+	subject.parallelFor("test", 10, visits.size(), [&](size_t i)
+	{
+		visits[i]++;
+	}, 7);
+
+	for(size_t i = 0; i < visits.size(); i++)
+		EXPECT_EQ(i < 10 ? 0 : 1, visits[i]);
+}
+
+TEST_F(CThreadPoolTest, parallelForEmptyRange)
+{
+	bool called = false;
+	subject.parallelFor("test", 5, 5, [&](size_t i)
+	{
+		called = true;
+	});
+	EXPECT_FALSE(called);
+}
+
+TEST_F(CThreadPoolTest, parallelForRethrows)
+{
+	EXPECT_THROW(subject.parallelFor("test", 0, 100, [](size_t i)
+	{
+		if(i == 50)
+			throw std::runtime_error("test");
+	}), std::runtime_error);
+}
+
+TEST_F(CThreadPoolTest, nestedGroupsDoNotDeadlock)
+{
+	std::atomic<int> counter(0);
+	CTaskGroup outer("outer", subject);
+	for(int i = 0; i < 16; i++)
+	{
+		outer.run([&]()
+		{
+			// every worker may be blocked in such wait, pending tasks are executed meanwhile
+			subject.parallelFor("inner", 0, 16, [&](size_t)
+			{
+				counter++;
+			});
+		});
+	}
+	outer.wait();
+	EXPECT_EQ(16 * 16, counter);
+}
+
+TEST_F(CThreadPoolTest, groupRethrowsFirstException)
+{
+	CTaskGroup group("test", subject);
+	group.run([]()
+	{
+		throw std::runtime_error("test");
+	});
+	EXPECT_THROW(group.wait(), std::runtime_error);
+	EXPECT_NO_THROW(group.wait());
+}
+
+TEST_F(CThreadPoolTest, asyncReturnsResult)
+{
+	auto result = subject.async([]()
+	{
+		return 42;
+	});
+	auto error = subject.async([]() -> int
+	{
+		throw std::runtime_error("test");
+	});
+	EXPECT_EQ(42, result.get());
+	EXPECT_THROW(error.get(), std::runtime_error);
+}
+
+TEST_F(CThreadPoolTest, statsCountTasksOfGroup)
+{
+	{
+		CTaskGroup group("counted", subject);
+		for(int i = 0; i < 5; i++)
+			group.run([](){});
+		group.runHere([](){});
+	}
+
+	auto stats = subject.getStats();
+	ASSERT_EQ(1, stats.count("counted"));
+	EXPECT_EQ(6, stats["counted"].tasks);
+
+	subject.resetStats();
+	EXPECT_TRUE(subject.getStats().empty());
+}
+
+TEST_F(CThreadPoolTest, loggedStatsAreReset)
+{
+	subject.parallelFor("logged", 0, 10, [](size_t){});
+	ASSERT_EQ(1, subject.getStats().count("logged"));
+
+	subject.logStats("test");
+	EXPECT_TRUE(subject.getStats().empty());
+}
@@ -0,0 +1,69 @@
+/*
+ * CObjectClonerBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/serializer/CObjectCloner.h"
+#include "../lib/serializer/CMemorySerializer.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+#include "../lib/mapObjects/CGTownInstance.h"
+#include "../lib/mapObjects/MiscObjects.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapping/CCampaignHandler.h"
+#include "../lib/CArtHandler.h"
+#include "../lib/CCreatureHandler.h"
+#include "../lib/CHeroHandler.h"
+
+#include "../game/GameFixtures.h"
+
+static const int BENCHMARK_BONUSES = 50;
+static const int BENCHMARK_ITERATIONS = 500;
+
+class CObjectClonerBenchmark : public ::testing::Test
+{
+public:
+	CGHeroInstance hero;
+
+	CObjectClonerBenchmark()
+	{
+		addTestArmy(hero, GameConstants::ARMY_SIZE, BENCHMARK_BONUSES);
+		for(int j = 0; j < BENCHMARK_BONUSES; j++)
+		{
+			auto bonus = std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::PRIMARY_SKILL, Bonus::HERO_BASE_SKILL, j, j, PrimarySkill::ATTACK);
+			bonus->limiter = std::make_shared<RankRangeLimiter>(1);
+			hero.addNewBonus(bonus);
+		}
+	}
+
+	/// Average wall clock time of one copy, in microseconds
+	double measure(const std::function<void()> & copy)
+	{
+		const auto start = boost::posix_time::microsec_clock::universal_time();
+		for(int i = 0; i < BENCHMARK_ITERATIONS; i++)
+			copy();
+		const auto duration = boost::posix_time::microsec_clock::universal_time() - start;
+		return static_cast<double>(duration.total_microseconds()) / BENCHMARK_ITERATIONS;
+	}
+};
+
+TEST_F(CObjectClonerBenchmark, heroCopy)
+{
+	const double roundTrip = measure([this]()
+	{
+		CMemorySerializer::deepCopy(hero);
+	});
+
+	const double cloned = measure([this]()
+	{
+		CObjectCloner::deepCopy(hero);
+	});
+
+	std::cout << "Hero with " << GameConstants::ARMY_SIZE << " stacks: "
+		<< roundTrip << " us serialization round-trip, " << cloned << " us cloned" << std::endl;
+}
@@ -0,0 +1,105 @@
+/*
+ * CPackSerializationBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/NetPacks.h"
+#include "../lib/serializer/Connection.h"
+
+static const int BENCHMARK_CLIENTS = 4;
+static const int BENCHMARK_PLAYERS = 8;
+static const int BENCHMARK_HEROES = 64;
+static const int BENCHMARK_TOWNS = 48;
+static const int BENCHMARK_ITERATIONS = 200;
+
+class CPackSerializationBenchmark : public ::testing::Test
+{
+public:
+	NewTurn pack;
+
+	CPackSerializationBenchmark()
+	{
+		pack.day = 7;
+		pack.specialWeek = NewTurn::NORMAL;
+
+		for(int i = 0; i < BENCHMARK_HEROES; i++)
+		{
+			NewTurn::Hero hero;
+			hero.id = ObjectInstanceID(i);
+			hero.move = 1500 + i;
+			hero.mana = 20 + i;
+			pack.heroes.insert(hero);
+		}
+
+		for(int i = 0; i < BENCHMARK_PLAYERS; i++)
+		{
+			TResources resources;
+			for(int j = 0; j < GameConstants::RESOURCE_QUANTITY; j++)
+				resources[j] = (j == Res::GOLD ? 20000 : 20) + i;
+			pack.res[PlayerColor(i)] = resources;
+		}
+
+		for(int i = 0; i < BENCHMARK_TOWNS; i++)
+		{
+			SetAvailableCreatures sac;
+			sac.tid = ObjectInstanceID(BENCHMARK_HEROES + i);
+			for(int level = 0; level < GameConstants::CREATURES_PER_TOWN; level++)
+			{
+				std::vector<CreatureID> creatures = {CreatureID(level * 2), CreatureID(level * 2 + 1)};
+				sac.creatures.push_back(std::make_pair(10 + level, creatures));
+			}
+			pack.cres[sac.tid] = sac;
+		}
+	}
+
+	/// Average wall clock time of sending pack to all clients, in microseconds
+	double measure(const std::function<void()> & send)
+	{
+		const auto start = boost::posix_time::microsec_clock::universal_time();
+		for(int i = 0; i < BENCHMARK_ITERATIONS; i++)
+			send();
+		const auto duration = boost::posix_time::microsec_clock::universal_time() - start;
+		return static_cast<double>(duration.total_microseconds()) / BENCHMARK_ITERATIONS;
+	}
+};
+
+TEST_F(CPackSerializationBenchmark, perClientAndShared)
+{
+	const CPack * info = &pack;
+
+	std::vector<std::unique_ptr<CConnectionBuffer>> clients;
+	for(int i = 0; i < BENCHMARK_CLIENTS; i++)
+		clients.push_back(make_unique<CConnectionBuffer>());
+
+	const double perClient = measure([&]()
+	{
+		for(auto & client : clients)
+		{
+			client->clear();
+			client->oser & info;
+		}
+	});
+
+	CConnectionBuffer shared;
+	std::vector<std::vector<ui8>> sent(BENCHMARK_CLIENTS);
+
+	const double once = measure([&]()
+	{
+		shared.clear();
+		shared.oser & info;
+		for(auto & data : sent)
+			data = shared.getData();
+	});
+
+	std::cout << "NewTurn of " << shared.getData().size() << " bytes to " << BENCHMARK_CLIENTS << " clients: "
+		<< perClient << " us serialized per client, " << once << " us serialized once" << std::endl;
+
+	for(int i = 0; i < BENCHMARK_CLIENTS; i++)
+		ASSERT_EQ(clients[i]->getData(), sent[i]);
+}
@@ -0,0 +1,105 @@
+/*
+ * CPathfinderBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/CGameState.h"
+#include "../lib/CPathfinder.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+
+#include "../game/GameFixtures.h"
+
+static const int BENCHMARK_HEROES = 8;
+static const int BENCHMARK_ITERATIONS = 10;
+
+class CPathfinderBenchmark : public ::testing::Test, public RandomMapGame
+{
+public:
+	std::vector<const CGHeroInstance *> heroes;
+	std::vector<std::unique_ptr<CPathsInfo>> paths;
+
+	CPathfinderBenchmark()
+		: RandomMapGame(CMapHeader::MAP_SIZE_XLARGE, true, BENCHMARK_HEROES)
+	{
+		for(auto hero : gs->map->heroesOnMap)
+		{
+			if(heroes.size() == BENCHMARK_HEROES)
+				break;
+
+			heroes.push_back(hero);
+			paths.push_back(make_unique<CPathsInfo>(mapSize));
+		}
+	}
+
+	/// Average wall clock time of full recalculation of paths of all heroes, in milliseconds
+	double measure(const std::function<void()> & calculate)
+	{
+		const auto start = boost::posix_time::microsec_clock::universal_time();
+		for(int i = 0; i < BENCHMARK_ITERATIONS; i++)
+		{
+			for(auto & heroPaths : paths)
+				heroPaths->invalidate();
+			calculate();
+		}
+		const auto duration = boost::posix_time::microsec_clock::universal_time() - start;
+		return duration.total_microseconds() / 1000.0 / BENCHMARK_ITERATIONS;
+	}
+};
+
+TEST_F(CPathfinderBenchmark, calculatePaths)
+{
+	ASSERT_FALSE(heroes.empty());
+
+	const double time = measure([this]()
+	{
+		gs->calculatePaths(heroes[0], *paths[0]);
+	});
+
+	std::cout << "Paths of one hero on " << gs->map->width << "x" << gs->map->height << "x" << (gs->map->twoLevel ? 2 : 1) << " map: "
+		<< time << " ms, " << sizeof(CGPathNode) * paths[0]->nodes.size() / 1024 << " KiB of nodes" << std::endl;
+}
+
+TEST_F(CPathfinderBenchmark, serialAndParallel)
+{
+	ASSERT_EQ(BENCHMARK_HEROES, heroes.size());
+
+	const double serial = measure([this]()
+	{
+		for(int i = 0; i < heroes.size(); i++)
+			gs->updatePaths(heroes[i], *paths[i]);
+	});
+
+	std::vector<std::vector<CGPathNode>> serialNodes;
+	for(auto & heroPaths : paths)
+		serialNodes.push_back(heroPaths->nodes);
+
+	std::vector<std::pair<const CGHeroInstance *, CPathsInfo *>> batch;
+	for(int i = 0; i < heroes.size(); i++)
+		batch.push_back(std::make_pair(heroes[i], paths[i].get()));
+
+	const double parallel = measure([&]()
+	{
+		gs->updatePaths(batch);
+	});
+
+	std::cout << "Paths of " << heroes.size() << " heroes on " << gs->map->width << "x" << gs->map->height << " map: "
+		<< serial << " ms serial, " << parallel << " ms parallel on " << boost::thread::hardware_concurrency() << " cores" << std::endl;
+
+	for(int i = 0; i < heroes.size(); i++)
+	{
+		for(size_t j = 0; j < serialNodes[i].size(); j++)
+		{
+			const CGPathNode & node = paths[i]->nodes[j];
+			ASSERT_EQ(serialNodes[i][j].turns, node.turns);
+			ASSERT_EQ(serialNodes[i][j].moveRemains, node.moveRemains);
+			ASSERT_EQ(serialNodes[i][j].action, node.action);
+		}
+	}
+}
@@ -0,0 +1,108 @@
+/*
+ * CRenderedTextCacheBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../client/gui/CRenderedTextCache.h"
+
+static const int BENCHMARK_FRAMES = 600;
+static const ui32 TEXT_COLOR = 0xf0e0a0;
+
+/// Replays labels that windows render every frame, rendering itself needs SDL and is not measured
+class CRenderedTextCacheBenchmark : public ::testing::Test
+{
+public:
+	struct FrameTrace
+	{
+		std::string name;
+		std::function<void(int, std::vector<std::string> &)> labels; // labels rendered in given frame
+	};
+
+	/// Hit rate in percent and average time of one lookup in nanoseconds
+	std::pair<double, double> replay(const FrameTrace & trace, size_t capacity)
+	{
+		std::vector<std::vector<std::string>> frames(BENCHMARK_FRAMES);
+		for(int frame = 0; frame < BENCHMARK_FRAMES; frame++)
+			trace.labels(frame, frames[frame]);
+
+		CRenderedTextCache<std::string> cache(capacity);
+		ui64 hits = 0, lookups = 0;
+
+		const auto start = boost::posix_time::microsec_clock::universal_time();
+		for(const auto & labels : frames)
+		{
+			for(const std::string & label : labels)
+			{
+				boost::unique_lock<boost::mutex> lock(cache.mx);
+				if(cache.find(label, TEXT_COLOR))
+					hits++;
+				else
+					cache.insert(label, TEXT_COLOR, label);
+				lookups++;
+			}
+		}
+		const auto duration = boost::posix_time::microsec_clock::universal_time() - start;
+
+		return std::make_pair(100.0 * hits / lookups, duration.total_microseconds() * 1000.0 / lookups);
+	}
+
+	static std::string number(int value)
+	{
+		return boost::lexical_cast<std::string>(value);
+	}
+};
+
+TEST_F(CRenderedTextCacheBenchmark, hitRate)
+{
+	std::vector<FrameTrace> traces;
+
+	// town screen: static labels, status bar changes as mouse moves over buildings
+	traces.push_back({"town screen", [](int frame, std::vector<std::string> & labels)
+	{
+		for(int i = 0; i < 7; i++)
+			labels.push_back(number(1000 + i * 37));
+		for(int i = 0; i < 14; i++)
+			labels.push_back(number(i * 3 + 1));
+		for(int i = 0; i < 40; i++)
+			labels.push_back("Building " + number(i));
+		labels.push_back("Status: building " + number(frame / 20 % 40));
+	}});
+
+	// scrolled list: 20 of 200 rows visible, list moves by one row every 10 frames
+	traces.push_back({"scrolled list", [](int frame, std::vector<std::string> & labels)
+	{
+		const int first = frame / 10 % 180;
+		for(int row = first; row < first + 20; row++)
+		{
+			labels.push_back("Hero " + number(row));
+			labels.push_back(number(row * 13 % 99));
+		}
+	}});
+
+	// kingdom overview: more distinct labels in one frame than 256 strings
+	traces.push_back({"kingdom overview", [](int frame, std::vector<std::string> & labels)
+	{
+		for(int row = 0; row < 10; row++)
+			for(int column = 0; column < 32; column++)
+				labels.push_back(number(row * 1000 + column));
+	}});
+
+	for(const FrameTrace & trace : traces)
+	{
+		for(size_t capacity : {128, 256, 512})
+		{
+			auto result = replay(trace, capacity);
+			std::cout << trace.name << ", " << capacity << " strings: "
+				<< result.first << "% hits, " << result.second << " ns per lookup" << std::endl;
+		}
+
+		// fonts keep 512 strings, none of these screens should render its text again each frame
+		EXPECT_GT(replay(trace, 512).first, 95.0) << trace.name;
+	}
+}
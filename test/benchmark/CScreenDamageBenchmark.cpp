@@ -0,0 +1,149 @@
+/*
+ * CScreenDamageBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include <SDL.h>
+
+#include "../client/gui/CScreenDamage.h"
+
+static const int BENCHMARK_WIDTH = 800;
+static const int BENCHMARK_HEIGHT = 600;
+static const int BENCHMARK_FRAMES = 300;
+
+/// Renders frames the way CGuiHandler does, headless with dummy video driver and software renderer
+class CScreenDamageBenchmark : public ::testing::Test
+{
+public:
+	SDL_Window * window;
+	SDL_Renderer * renderer;
+	SDL_Texture * texture;
+	SDL_Surface * screen;
+
+	CScreenDamageBenchmark()
+		: window(nullptr), renderer(nullptr), texture(nullptr), screen(nullptr)
+	{
+		if(SDL_VideoInit("dummy") != 0)
+			return;
+
+		window = SDL_CreateWindow("benchmark", 0, 0, BENCHMARK_WIDTH, BENCHMARK_HEIGHT, 0);
+		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+		texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+		screen = SDL_CreateRGBSurface(0, BENCHMARK_WIDTH, BENCHMARK_HEIGHT, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+	}
+
+	~CScreenDamageBenchmark()
+	{
+		if(screen)
+			SDL_FreeSurface(screen);
+		if(texture)
+			SDL_DestroyTexture(texture);
+		if(renderer)
+			SDL_DestroyRenderer(renderer);
+		if(window)
+			SDL_DestroyWindow(window);
+		SDL_VideoQuit();
+	}
+
+	/// Widgets report areas they have drawn to, unless damage is null
+	void drawFrame(int frame, int animatedAreas, CScreenDamage * damage)
+	{
+		if(frame == 0)
+			SDL_FillRect(screen, nullptr, 0xff203040);
+
+		// animated widgets and cursor move a bit every frame
+		for(int i = 0; i < animatedAreas; i++)
+		{
+			SDL_Rect area = {(i * 97 + frame * 3) % (BENCHMARK_WIDTH - 64), (i * 61) % (BENCHMARK_HEIGHT - 64), 64, 64};
+			SDL_FillRect(screen, &area, 0xff000000 + (frame * 0x010307 + i * 0x100000) % 0xffffff);
+			if(damage)
+				damage->invalidate(area);
+		}
+	}
+
+	void presentFull()
+	{
+		SDL_UpdateTexture(texture, nullptr, screen->pixels, screen->pitch);
+		SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+		SDL_RenderPresent(renderer);
+	}
+
+	void presentDamaged(CScreenDamage & damage)
+	{
+		const auto & rects = damage.update(screen->pixels, screen->w, screen->h, screen->pitch, 4);
+		for(const SDL_Rect & rect : rects)
+		{
+			const ui8 * pixels = static_cast<const ui8 *>(screen->pixels) + rect.y * screen->pitch + rect.x * 4;
+			SDL_UpdateTexture(texture, &rect, pixels, screen->pitch);
+		}
+		if(!rects.empty())
+		{
+			SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+			SDL_RenderPresent(renderer);
+		}
+	}
+
+	/// Average time of one frame in milliseconds
+	double measure(int animatedAreas, CScreenDamage * damage, const std::function<void()> & present)
+	{
+		const auto start = boost::posix_time::microsec_clock::universal_time();
+		for(int frame = 0; frame < BENCHMARK_FRAMES; frame++)
+		{
+			drawFrame(frame, animatedAreas, damage);
+			present();
+		}
+		const auto duration = boost::posix_time::microsec_clock::universal_time() - start;
+		return duration.total_microseconds() / 1000.0 / BENCHMARK_FRAMES;
+	}
+
+	void expectTextureMatchesScreen()
+	{
+		std::vector<ui8> shown(screen->pitch * screen->h);
+		SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+		ASSERT_EQ(0, SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, shown.data(), screen->pitch));
+		for(int y = 0; y < screen->h; y++)
+		{
+			const ui8 * row = static_cast<const ui8 *>(screen->pixels) + y * screen->pitch;
+			ASSERT_EQ(0, memcmp(row, shown.data() + y * screen->pitch, screen->w * 4)) << "row " << y;
+		}
+	}
+};
+
+TEST_F(CScreenDamageBenchmark, fullAndDamagedUpload)
+{
+	ASSERT_TRUE(screen && texture) << SDL_GetError();
+
+	for(int animatedAreas : {0, 2, 16})
+	{
+		const double full = measure(animatedAreas, nullptr, [this]()
+		{
+			presentFull();
+		});
+
+		// windows that do not report their changes have whole area compared every frame
+		CScreenDamage wholeFrame;
+		const double compared = measure(animatedAreas, nullptr, [&]()
+		{
+			wholeFrame.invalidate(screen->clip_rect);
+			presentDamaged(wholeFrame);
+		});
+		expectTextureMatchesScreen();
+
+		CScreenDamage reported;
+		const double damaged = measure(animatedAreas, &reported, [&]()
+		{
+			presentDamaged(reported);
+		});
+		expectTextureMatchesScreen();
+
+		std::cout << BENCHMARK_WIDTH << "x" << BENCHMARK_HEIGHT << " frame with " << animatedAreas << " animated areas: "
+			<< full << " ms full upload, " << compared << " ms whole frame compared, "
+			<< damaged << " ms reported areas only" << std::endl;
+	}
+}
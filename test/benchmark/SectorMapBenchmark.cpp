@@ -0,0 +1,174 @@
+/*
+ * SectorMapBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../AI/VCAI/SectorMap.h"
+#include "../lib/CGameState.h"
+#include "../lib/CGameInfoCallback.h"
+#include "../lib/CFogOfWarMap.h"
+#include "../lib/CPlayerState.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+
+#include "../game/GameFixtures.h"
+
+static const int BENCHMARK_PLAYERS = 4;
+static const int BENCHMARK_STEPS = 60;
+static const int BENCHMARK_STEP_LENGTH = 3;
+static const int BENCHMARK_SIGHT_RADIUS = 6;
+static const int BENCHMARK_BATTLE_EVERY = 5;
+
+/// Information available to AI of one player
+class SectorMapBenchmarkCallback : public CPlayerSpecificInfoCallback
+{
+public:
+	SectorMapBenchmarkCallback(CGameState * GS, PlayerColor color)
+	{
+		gs = GS;
+		player = color;
+	}
+};
+
+/// Replays scripted turn of AI: hero walks towards center of map revealing tiles on its way and defeats monsters it sees.
+/// After each step sector map is updated incrementally and built again from scratch.
+class SectorMapBenchmark : public ::testing::Test, public RandomMapGame
+{
+public:
+	std::unique_ptr<SectorMapBenchmarkCallback> playerCb;
+	const CGHeroInstance * hero;
+
+	SectorMapBenchmark()
+		: RandomMapGame(CMapHeader::MAP_SIZE_XLARGE, true, BENCHMARK_PLAYERS), hero(nullptr)
+	{
+		for(auto h : gs->map->heroesOnMap)
+		{
+			if(h->tempOwner == PlayerColor(0))
+			{
+				hero = h;
+				break;
+			}
+		}
+		playerCb = make_unique<SectorMapBenchmarkCallback>(gs.get(), PlayerColor(0));
+	}
+
+	CFogOfWarMap & fogOfWar()
+	{
+		return gs->teams.at(gs->players.at(PlayerColor(0)).team).fogOfWarMap;
+	}
+
+	/// Monsters seen by player which were not defeated yet
+	std::vector<CGObjectInstance *> visibleMonsters(const std::set<CGObjectInstance *> & defeated)
+	{
+		std::vector<CGObjectInstance *> ret;
+		for(auto & obj : gs->map->objects)
+		{
+			if(obj && obj->ID == Obj::MONSTER && !vstd::contains(defeated, obj.get()) && fogOfWar().isVisible(obj->visitablePos()))
+				ret.push_back(obj.get());
+		}
+		return ret;
+	}
+
+	/// Both maps divide map into same sectors, ids of sectors may differ
+	static void expectSameSectors(SectorMap & expected, SectorMap & actual)
+	{
+		std::map<int, int> ids;
+		for(int z = 0; z < expected.sizes.z; z++)
+			for(int x = 0; x < expected.sizes.x; x++)
+				for(int y = 0; y < expected.sizes.y; y++)
+				{
+					const int3 pos(x, y, z);
+					const int expectedId = expected.retreiveTile(pos);
+					const int actualId = actual.retreiveTile(pos);
+					if(expectedId <= NOT_AVAILABLE || actualId <= NOT_AVAILABLE)
+					{
+						ASSERT_EQ(expectedId, actualId) << pos.toString();
+						continue;
+					}
+					auto mapped = ids.insert(std::make_pair(expectedId, actualId));
+					ASSERT_EQ(mapped.first->second, actualId) << pos.toString();
+				}
+
+		EXPECT_EQ(expected.infoOnSectors.size(), actual.infoOnSectors.size());
+		for(auto & mapped : ids)
+		{
+			auto expectedSector = expected.infoOnSectors.at(mapped.first);
+			auto actualSector = actual.infoOnSectors.at(mapped.second);
+			for(auto sector : {&expectedSector, &actualSector})
+			{
+				boost::sort(sector->tiles);
+				boost::sort(sector->embarkmentPoints);
+				boost::sort(sector->visitableObjs);
+			}
+			EXPECT_EQ(expectedSector.water, actualSector.water);
+			EXPECT_EQ(expectedSector.tiles, actualSector.tiles);
+			EXPECT_EQ(expectedSector.embarkmentPoints, actualSector.embarkmentPoints);
+			EXPECT_EQ(expectedSector.visitableObjs, actualSector.visitableObjs);
+		}
+	}
+};
+
+TEST_F(SectorMapBenchmark, scriptedTurn)
+{
+	ASSERT_TRUE(hero != nullptr);
+
+	SectorMap incremental(playerCb.get());
+	incremental.update();
+
+	const int3 start = hero->visitablePos();
+	const int3 target(gs->map->width / 2, gs->map->height / 2, start.z);
+	std::set<CGObjectInstance *> defeated;
+	boost::posix_time::time_duration fullTime, incrementalTime;
+	std::unique_ptr<SectorMap> full;
+
+	for(int step = 1; step <= BENCHMARK_STEPS; step++)
+	{
+		const double progress = std::min(1.0, static_cast<double>(step * BENCHMARK_STEP_LENGTH) / std::max(1.0, start.dist2d(target)));
+		const int3 scout(start.x + (target.x - start.x) * progress, start.y + (target.y - start.y) * progress, start.z);
+
+		for(int x = scout.x - BENCHMARK_SIGHT_RADIUS; x <= scout.x + BENCHMARK_SIGHT_RADIUS; x++)
+			for(int y = scout.y - BENCHMARK_SIGHT_RADIUS; y <= scout.y + BENCHMARK_SIGHT_RADIUS; y++)
+			{
+				const int3 pos(x, y, scout.z);
+				if(gs->map->isInTheMap(pos) && !fogOfWar().isVisible(pos) && pos.dist2d(scout) <= BENCHMARK_SIGHT_RADIUS)
+				{
+					fogOfWar().setVisible(pos, true);
+					incremental.invalidate(pos);
+				}
+			}
+
+		if(step % BENCHMARK_BATTLE_EVERY == 0)
+		{
+			for(auto monster : visibleMonsters(defeated))
+			{
+				incremental.invalidate(monster);
+				gs->map->removeBlockVisTiles(monster, true);
+				defeated.insert(monster);
+			}
+		}
+
+		auto begin = boost::posix_time::microsec_clock::universal_time();
+		incremental.update();
+		auto end = boost::posix_time::microsec_clock::universal_time();
+		incrementalTime += end - begin;
+
+		begin = end;
+		full = make_unique<SectorMap>(playerCb.get());
+		full->update();
+		end = boost::posix_time::microsec_clock::universal_time();
+		fullTime += end - begin;
+	}
+
+	expectSameSectors(*full, incremental);
+
+	std::cout << "Sector map of " << gs->map->width << "x" << gs->map->height << "x" << (gs->map->twoLevel ? 2 : 1) << " map during "
+		<< BENCHMARK_STEPS << " steps, " << defeated.size() << " monsters defeated: "
+		<< fullTime.total_microseconds() / 1000.0 << " ms rebuilt, "
+		<< incrementalTime.total_microseconds() / 1000.0 << " ms incremental" << std::endl;
+}
@@ -0,0 +1,320 @@
+/*
+ * CBonusSystemNodeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/HeroBonus.h"
+
+// Bonus tree shaped like the one of a 144x144 (XL) map with 8 players:
+// global effects -> player -> hero -> stacks
+static const int PLAYERS = 8;
+static const int HEROES_PER_PLAYER = 8;
+static const int STACKS_PER_HERO = 7;
+
+static const std::string CACHING_STR = "type_PRIMARY_SKILL";
+
+class CBonusSystemNodeTest : public ::testing::Test
+{
+public:
+	CBonusSystemNode globalEffects;
+	std::vector<std::unique_ptr<CBonusSystemNode>> players;
+	std::vector<std::unique_ptr<CBonusSystemNode>> heroes;
+	std::vector<std::unique_ptr<CBonusSystemNode>> stacks;
+
+	std::map<const CBonusSystemNode *, TBonusListPtr> lastResults;
+
+	CBonusSystemNodeTest()
+	{
+		globalEffects.setNodeType(CBonusSystemNode::GLOBAL_EFFECTS);
+
+		for(int p = 0; p < PLAYERS; p++)
+		{
+			players.push_back(make_unique<CBonusSystemNode>());
+			players.back()->setNodeType(CBonusSystemNode::PLAYER);
+			players.back()->attachTo(&globalEffects);
+
+			for(int h = 0; h < HEROES_PER_PLAYER; h++)
+			{
+				heroes.push_back(make_unique<CBonusSystemNode>());
+				heroes.back()->setNodeType(CBonusSystemNode::HERO);
+				heroes.back()->attachTo(players.back().get());
+
+				for(int s = 0; s < STACKS_PER_HERO; s++)
+				{
+					stacks.push_back(make_unique<CBonusSystemNode>());
+					stacks.back()->setNodeType(CBonusSystemNode::STACK_INSTANCE);
+					stacks.back()->attachTo(heroes.back().get());
+				}
+			}
+		}
+	}
+
+	~CBonusSystemNodeTest()
+	{
+		//children have to go first
+		stacks.clear();
+		heroes.clear();
+		players.clear();
+	}
+
+	static std::shared_ptr<Bonus> makeBonus(si32 val)
+	{
+		return std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::PRIMARY_SKILL, Bonus::OTHER, val, 0, PrimarySkill::ATTACK);
+	}
+
+	template<typename Func>
+	void forEachNode(Func f)
+	{
+		f(&globalEffects);
+		for(auto & n : players)
+			f(n.get());
+		for(auto & n : heroes)
+			f(n.get());
+		for(auto & n : stacks)
+			f(n.get());
+	}
+
+	//queries every node of the map and returns how many of them had to rebuild their cached bonuses
+	int queryAll()
+	{
+		int rebuilt = 0;
+		forEachNode([&](const CBonusSystemNode * node)
+		{
+			auto result = node->getBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR);
+			auto & last = lastResults[node];
+			if(last != result)
+				rebuilt++;
+			last = result;
+		});
+		return rebuilt;
+	}
+
+	int nodesCount() const
+	{
+		return 1 + players.size() + heroes.size() + stacks.size();
+	}
+
+	CBonusSystemNode * hero(int player, int index)
+	{
+		return heroes[player * HEROES_PER_PLAYER + index].get();
+	}
+
+	CBonusSystemNode * stack(int player, int hero, int index)
+	{
+		return stacks[(player * HEROES_PER_PLAYER + hero) * STACKS_PER_HERO + index].get();
+	}
+};
+
+TEST_F(CBonusSystemNodeTest, repeatedQueriesAreCached)
+{
+	EXPECT_EQ(queryAll(), nodesCount());
+	EXPECT_EQ(queryAll(), 0);
+}
+
+TEST_F(CBonusSystemNodeTest, heroBonusInvalidatesOnlyHeroAndItsStacks)
+{
+	queryAll();
+
+	hero(3, 2)->addNewBonus(makeBonus(2));
+
+	EXPECT_EQ(queryAll(), 1 + STACKS_PER_HERO);
+	EXPECT_EQ(hero(3, 2)->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 2);
+	EXPECT_EQ(stack(3, 2, 6)->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 2);
+	EXPECT_EQ(hero(3, 1)->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 0);
+}
+
+TEST_F(CBonusSystemNodeTest, playerBonusInvalidatesOnlyPlayerSubtree)
+{
+	queryAll();
+
+	auto bonus = makeBonus(1);
+	players[5]->addNewBonus(bonus);
+
+	EXPECT_EQ(queryAll(), 1 + HEROES_PER_PLAYER * (1 + STACKS_PER_HERO));
+	EXPECT_EQ(stack(5, 7, 0)->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 1);
+
+	players[5]->removeBonus(bonus);
+
+	EXPECT_EQ(queryAll(), 1 + HEROES_PER_PLAYER * (1 + STACKS_PER_HERO));
+	EXPECT_EQ(stack(5, 7, 0)->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 0);
+}
+
+TEST_F(CBonusSystemNodeTest, reattachInvalidatesOnlyMovedNode)
+{
+	hero(1, 0)->addNewBonus(makeBonus(3));
+	queryAll();
+
+	CBonusSystemNode * moved = stack(0, 0, 0);
+	moved->detachFrom(hero(0, 0));
+	moved->attachTo(hero(1, 0));
+
+	EXPECT_EQ(queryAll(), 1);
+	EXPECT_EQ(moved->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 3);
+}
+
+TEST_F(CBonusSystemNodeTest, propagatedBonusInvalidatesTargetSubtree)
+{
+	queryAll();
+
+	//bonus exported by stack but effective on whole player (like "+1 morale" of a creature)
+	auto bonus = makeBonus(4);
+	bonus->addPropagator(std::make_shared<CPropagatorNodeType>(CBonusSystemNode::PLAYER));
+	stack(2, 0, 0)->addNewBonus(bonus);
+
+	EXPECT_EQ(queryAll(), 1 + HEROES_PER_PLAYER * (1 + STACKS_PER_HERO));
+	EXPECT_EQ(hero(2, 5)->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 4);
+	EXPECT_EQ(hero(1, 5)->valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR), 0);
+}
+
+TEST_F(CBonusSystemNodeTest, directListChangeInvalidatesOwnerSubtree)
+{
+	queryAll();
+
+	hero(6, 3)->getExportedBonusList().push_back(makeBonus(1));
+
+	EXPECT_EQ(queryAll(), 1 + STACKS_PER_HERO);
+}
+
+TEST_F(CBonusSystemNodeTest, treeHasChangedInvalidatesEverything)
+{
+	queryAll();
+
+	CBonusSystemNode::treeHasChanged();
+
+	EXPECT_EQ(queryAll(), nodesCount());
+}
+
+TEST_F(CBonusSystemNodeTest, parallelQueriesMatchSerialResults)
+{
+	static const int THREADS = 8;
+	static const int ITERATIONS = 20;
+
+	std::vector<std::pair<CSelector, std::string>> queries =
+	{
+		{Selector::type(Bonus::PRIMARY_SKILL), CACHING_STR},
+		{Selector::typeSubtype(Bonus::PRIMARY_SKILL, PrimarySkill::ATTACK), "type_PRIMARY_SKILLs_0"},
+		{Selector::type(Bonus::MORALE), "type_MORALE"},
+		{Selector::type(Bonus::LUCK), ""}
+	};
+
+	globalEffects.addNewBonus(std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::LUCK, Bonus::OTHER, 1, 0));
+	for(int p = 0; p < PLAYERS; p++)
+	{
+		players[p]->addNewBonus(std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::MORALE, Bonus::OTHER, p, 0));
+		for(int h = 0; h < HEROES_PER_PLAYER; h++)
+			hero(p, h)->addNewBonus(makeBonus(h + 1));
+	}
+
+	std::vector<const CBonusSystemNode *> nodes;
+	forEachNode([&](const CBonusSystemNode * node)
+	{
+		nodes.push_back(node);
+	});
+
+	std::map<const CBonusSystemNode *, std::vector<int>> expected;
+	for(auto node : nodes)
+		for(auto & query : queries)
+			expected[node].push_back(node->valOfBonuses(query.first, query.second));
+
+	//start from cold caches so that threads race on rebuilding them
+	CBonusSystemNode::treeHasChanged();
+
+	std::atomic<int> mismatches(0);
+	boost::thread_group threads;
+	for(int t = 0; t < THREADS; t++)
+	{
+		threads.create_thread([&, t]()
+		{
+			std::mt19937 rng(t);
+			auto order = nodes;
+			for(int i = 0; i < ITERATIONS; i++)
+			{
+				std::shuffle(order.begin(), order.end(), rng);
+				for(auto node : order)
+					for(int q = 0; q < queries.size(); q++)
+						if(node->valOfBonuses(queries[q].first, queries[q].second) != expected.at(node)[q])
+							mismatches++;
+			}
+		});
+	}
+	threads.join_all();
+
+	EXPECT_EQ(mismatches, 0);
+}
+
+TEST_F(CBonusSystemNodeTest, typedQueriesMatchSelectorQueries)
+{
+	auto check = [](CBonusSystemNode * node)
+	{
+		for(int skill = PrimarySkill::ATTACK; skill <= PrimarySkill::KNOWLEDGE; skill++)
+		{
+			auto bonuses = node->getBonuses(Selector::typeSubtype(Bonus::PRIMARY_SKILL, skill));
+			EXPECT_EQ(node->valOfBonuses(Bonus::PRIMARY_SKILL, skill), bonuses->totalValue());
+			EXPECT_EQ(node->hasBonusOfType(Bonus::PRIMARY_SKILL, skill), !bonuses->empty());
+		}
+		EXPECT_EQ(node->valOfBonuses(Bonus::PRIMARY_SKILL), node->getBonuses(Selector::type(Bonus::PRIMARY_SKILL))->totalValue());
+		EXPECT_EQ(node->valOfBonuses(Bonus::MORALE), node->getBonuses(Selector::type(Bonus::MORALE))->totalValue());
+	};
+
+	CBonusSystemNode * node = stack(4, 4, 4);
+	check(node);
+
+	players[4]->addNewBonus(std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::MORALE, Bonus::OTHER, 2, 0));
+	hero(4, 4)->addNewBonus(makeBonus(5));
+	node->addNewBonus(std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::PRIMARY_SKILL, Bonus::OTHER, 50, 0, PrimarySkill::ATTACK, Bonus::PERCENT_TO_ALL));
+	node->addNewBonus(std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::PRIMARY_SKILL, Bonus::OTHER, 3, 0, PrimarySkill::KNOWLEDGE));
+
+	check(node);
+	EXPECT_EQ(node->valOfBonuses(Bonus::PRIMARY_SKILL, PrimarySkill::ATTACK), 7);
+	EXPECT_EQ(node->valOfBonuses(Bonus::MORALE), 2);
+
+	node->detachFrom(hero(4, 4));
+
+	check(node);
+	EXPECT_EQ(node->valOfBonuses(Bonus::PRIMARY_SKILL, PrimarySkill::ATTACK), 0);
+	EXPECT_FALSE(node->hasBonusOfType(Bonus::MORALE));
+
+	node->attachTo(hero(4, 4));
+}
+
+TEST_F(CBonusSystemNodeTest, typedQueriesSeeValueChangedInPlace)
+{
+	CBonusSystemNode * node = stack(4, 4, 4);
+	auto bonus = std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::PRIMARY_SKILL, Bonus::OTHER, 3, 0, PrimarySkill::DEFENSE);
+	node->addNewBonus(bonus);
+
+	const int before = node->valOfBonuses(Bonus::PRIMARY_SKILL, PrimarySkill::DEFENSE);
+	const int total = node->valOfBonuses(Bonus::PRIMARY_SKILL);
+
+	// some game mechanics modify existing bonuses without notifying bonus system
+	bonus->val += 10;
+
+	EXPECT_EQ(before + 10, node->valOfBonuses(Bonus::PRIMARY_SKILL, PrimarySkill::DEFENSE));
+	EXPECT_EQ(total + 10, node->valOfBonuses(Bonus::PRIMARY_SKILL));
+	EXPECT_EQ(node->getBonuses(Selector::typeSubtype(Bonus::PRIMARY_SKILL, PrimarySkill::DEFENSE))->totalValue(),
+		node->valOfBonuses(Bonus::PRIMARY_SKILL, PrimarySkill::DEFENSE));
+}
+
+TEST_F(CBonusSystemNodeTest, typedQueriesIgnoreLimitedEffectRange)
+{
+	// like luck penalty of devils, it affects enemy army only
+	CBonusSystemNode * node = stack(4, 4, 4);
+	auto enemyLuck = std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::LUCK, Bonus::CREATURE_ABILITY, -1, 0);
+	enemyLuck->effectRange = Bonus::ONLY_ENEMY_ARMY;
+	node->addNewBonus(enemyLuck);
+
+	for(int i = 0; i < 2; i++) // second query is answered from cache
+	{
+		EXPECT_EQ(0, node->valOfBonuses(Bonus::LUCK));
+		EXPECT_EQ(0, node->valOfBonuses(Bonus::LUCK, 0));
+		EXPECT_FALSE(node->hasBonusOfType(Bonus::LUCK));
+		EXPECT_FALSE(node->hasBonusOfType(Bonus::LUCK, 0));
+	}
+	EXPECT_EQ(-1, node->getBonuses(Selector::type(Bonus::LUCK), Selector::effectRange(Bonus::ONLY_ENEMY_ARMY))->totalValue());
+}
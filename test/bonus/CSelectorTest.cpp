@@ -0,0 +1,90 @@
+/*
+ * CSelectorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/HeroBonus.h"
+
+class CSelectorTest : public ::testing::Test
+{
+public:
+	std::vector<std::shared_ptr<Bonus>> bonuses;
+
+	CSelectorTest()
+	{
+		for(auto type : {Bonus::PRIMARY_SKILL, Bonus::STACKS_SPEED, Bonus::MORALE})
+		{
+			for(auto source : {Bonus::ARTIFACT, Bonus::SPELL_EFFECT})
+			{
+				for(int subtype = -1; subtype < 2; subtype++)
+				{
+					for(ui32 sid = 0; sid < 2; sid++)
+					{
+						auto b = std::make_shared<Bonus>(Bonus::PERMANENT, type, source, 1, sid, subtype);
+						b->additionalInfo = subtype + sid;
+						b->valType = sid ? Bonus::BASE_NUMBER : Bonus::ADDITIVE_VALUE;
+						bonuses.push_back(b);
+					}
+				}
+			}
+		}
+	}
+
+	//selector that goes through std::function, as every selector did before field matchers
+	static CSelector asLambda(const CSelector & selector)
+	{
+		return [selector](const Bonus * b){ return selector(b); };
+	}
+
+	void expectSameSelection(const CSelector & compiled, const CSelector & reference)
+	{
+		int selected = 0;
+		for(auto & b : bonuses)
+		{
+			EXPECT_EQ(reference(b.get()), compiled(b.get()));
+			selected += compiled(b.get());
+		}
+		EXPECT_GT(selected, 0);
+	}
+};
+
+TEST_F(CSelectorTest, fieldSelectorsMatchPlainComparisons)
+{
+	expectSameSelection(Selector::type(Bonus::MORALE), [](const Bonus * b){ return b->type == Bonus::MORALE; });
+	expectSameSelection(Selector::subtype(1), [](const Bonus * b){ return b->subtype == 1; });
+	expectSameSelection(Selector::info(2), [](const Bonus * b){ return b->additionalInfo == 2; });
+	expectSameSelection(Selector::sourceTypeSel(Bonus::ARTIFACT), [](const Bonus * b){ return b->source == Bonus::ARTIFACT; });
+	expectSameSelection(Selector::source(Bonus::SPELL_EFFECT, 1), [](const Bonus * b){ return b->source == Bonus::SPELL_EFFECT && b->sid == 1; });
+	expectSameSelection(Selector::valueType(Bonus::BASE_NUMBER), [](const Bonus * b){ return b->valType == Bonus::BASE_NUMBER; });
+	expectSameSelection(Selector::typeSubtypeInfo(Bonus::PRIMARY_SKILL, 0, 1),
+		[](const Bonus * b){ return b->type == Bonus::PRIMARY_SKILL && b->subtype == 0 && b->additionalInfo == 1; });
+	expectSameSelection(Selector::all, [](const Bonus * b){ return true; });
+}
+
+TEST_F(CSelectorTest, combinedSelectorsMatchLambdaCombinations)
+{
+	auto typeSel = Selector::type(Bonus::STACKS_SPEED);
+	auto subtypeSel = Selector::subtype(-1);
+	auto sourceSel = Selector::source(Bonus::ARTIFACT, 0);
+
+	expectSameSelection(typeSel.And(subtypeSel).And(sourceSel), asLambda(typeSel).And(asLambda(subtypeSel)).And(asLambda(sourceSel)));
+	expectSameSelection(typeSel.Or(sourceSel).And(subtypeSel), asLambda(typeSel).Or(asLambda(sourceSel)).And(asLambda(subtypeSel)));
+	expectSameSelection(typeSel.And(Selector::turns(1)), asLambda(typeSel).And(asLambda(Selector::turns(1))));
+}
+
+TEST_F(CSelectorTest, contradictingFieldsSelectNothing)
+{
+	auto sel = Selector::type(Bonus::MORALE).And(Selector::type(Bonus::STACKS_SPEED));
+	EXPECT_TRUE(sel);
+	for(auto & b : bonuses)
+		EXPECT_FALSE(sel(b.get()));
+
+	EXPECT_TRUE(Selector::matchesType(Selector::type(Bonus::MORALE), Bonus::MORALE));
+	EXPECT_FALSE(Selector::matchesTypeSubtype(Selector::typeSubtype(Bonus::MORALE, 1), Bonus::MORALE, 0));
+}
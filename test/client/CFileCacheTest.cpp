@@ -0,0 +1,145 @@
+/*
+ * CFileCacheTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../client/gui/CFileCache.h"
+
+static const size_t FILE_SIZE = 100;
+
+struct CFileCacheTest : testing::Test
+{
+	std::map<std::string, std::atomic<int>> loads;
+	boost::mutex loadsMx;
+
+	CFileCache subject;
+
+	CFileCacheTest()
+		: subject(3 * FILE_SIZE, [this](const ResourceID & rid){ return load(rid); })
+	{
+	}
+
+	// every file is filled with first letter of its name, big files have size stored in name: "BIG_250"
+	std::pair<CFileCache::TFileData, size_t> load(const ResourceID & rid)
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(loadsMx);
+			loads[rid.getName()]++;
+		}
+
+		size_t size = FILE_SIZE;
+		if(boost::starts_with(rid.getName(), "BIG_"))
+			size = boost::lexical_cast<size_t>(rid.getName().substr(4));
+
+		ui8 * data = new ui8[size];
+		std::fill_n(data, size, rid.getName()[0]);
+		return std::make_pair(CFileCache::TFileData(data, std::default_delete<ui8[]>()), size);
+	}
+
+	static ResourceID file(const std::string & name)
+	{
+		return ResourceID(name, EResType::ANIMATION);
+	}
+
+	int loadCount(const std::string & name)
+	{
+		return loads[file(name).getName()];
+	}
+};
+
+TEST_F(CFileCacheTest, cachedFileIsSharedNotReloaded)
+{
+	auto first = subject.getCachedFile(file("A"));
+	auto second = subject.getCachedFile(file("A"));
+
+	EXPECT_EQ(first.get(), second.get());
+	EXPECT_EQ(1, loadCount("A"));
+	EXPECT_EQ(FILE_SIZE, subject.size());
+}
+
+TEST_F(CFileCacheTest, leastRecentlyUsedFileIsEvicted)
+{
+	subject.getCachedFile(file("A"));
+	subject.getCachedFile(file("B"));
+	subject.getCachedFile(file("C"));
+	subject.getCachedFile(file("A")); // B is now least recently used
+	subject.getCachedFile(file("D"));
+
+	EXPECT_TRUE(subject.contains(file("A")));
+	EXPECT_FALSE(subject.contains(file("B")));
+	EXPECT_TRUE(subject.contains(file("C")));
+	EXPECT_TRUE(subject.contains(file("D")));
+	EXPECT_EQ(3 * FILE_SIZE, subject.size());
+	EXPECT_EQ(1, loadCount("A"));
+}
+
+TEST_F(CFileCacheTest, evictedFileStaysValidWhileHeld)
+{
+	auto held = subject.getCachedFile(file("A"));
+	std::weak_ptr<const ui8> watch = held;
+
+	subject.getCachedFile(file("B"));
+	subject.getCachedFile(file("C"));
+	subject.getCachedFile(file("D"));
+	ASSERT_FALSE(subject.contains(file("A")));
+
+	// cache no longer owns buffer, but image still using it does
+	ASSERT_FALSE(watch.expired());
+	EXPECT_EQ('A', held.get()[0]);
+	EXPECT_EQ('A', held.get()[FILE_SIZE - 1]);
+
+	auto reloaded = subject.getCachedFile(file("A"));
+	EXPECT_NE(held.get(), reloaded.get());
+	EXPECT_EQ(2, loadCount("A"));
+
+	held.reset();
+	EXPECT_TRUE(watch.expired());
+	EXPECT_EQ('A', reloaded.get()[0]);
+}
+
+TEST_F(CFileCacheTest, evictedFileIsFreedWhenReleased)
+{
+	std::weak_ptr<const ui8> watch = subject.getCachedFile(file("A"));
+
+	subject.getCachedFile(file("B"));
+	subject.getCachedFile(file("C"));
+	EXPECT_FALSE(watch.expired());
+
+	subject.getCachedFile(file("D"));
+	EXPECT_TRUE(watch.expired());
+}
+
+TEST_F(CFileCacheTest, fileLargerThanLimitIsKeptAlone)
+{
+	subject.getCachedFile(file("A"));
+	subject.getCachedFile(file("BIG_500"));
+
+	EXPECT_FALSE(subject.contains(file("A")));
+	EXPECT_TRUE(subject.contains(file("BIG_500")));
+	EXPECT_EQ(500u, subject.size());
+
+	subject.getCachedFile(file("B"));
+	EXPECT_FALSE(subject.contains(file("BIG_500")));
+	EXPECT_EQ(FILE_SIZE, subject.size());
+}
+
+TEST_F(CFileCacheTest, prefetchLoadsOnlyMissingFiles)
+{
+	subject.getCachedFile(file("A"));
+	subject.prefetch({file("A"), file("B"), file("C")});
+
+	EXPECT_TRUE(subject.contains(file("B")));
+	EXPECT_TRUE(subject.contains(file("C")));
+	EXPECT_EQ(1, loadCount("A"));
+	EXPECT_EQ(1, loadCount("B"));
+	EXPECT_EQ(1, loadCount("C"));
+
+	subject.getCachedFile(file("B"));
+	EXPECT_EQ(1, loadCount("B"));
+}
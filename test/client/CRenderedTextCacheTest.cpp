@@ -0,0 +1,103 @@
+/*
+ * CRenderedTextCacheTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../client/gui/CRenderedTextCache.h"
+
+static const ui32 YELLOW = 0xffff00;
+static const ui32 WHITE = 0xffffff;
+
+/// Stands for rendered surface, counts how many are alive
+struct FakeRenderedText
+{
+	std::string text;
+	std::shared_ptr<int> alive;
+
+	FakeRenderedText(const std::string & text, std::shared_ptr<int> alive)
+		: text(text), alive(alive)
+	{
+		++*alive;
+	}
+
+	FakeRenderedText(FakeRenderedText && other)
+		: text(std::move(other.text)), alive(std::move(other.alive))
+	{
+	}
+
+	~FakeRenderedText()
+	{
+		if(alive)
+			--*alive;
+	}
+};
+
+struct CRenderedTextCacheTest : testing::Test
+{
+	std::shared_ptr<int> alive;
+	CRenderedTextCache<FakeRenderedText> subject;
+
+	CRenderedTextCacheTest()
+		: alive(std::make_shared<int>(0)), subject(3)
+	{
+	}
+
+	void render(const std::string & text, ui32 color = YELLOW)
+	{
+		if(!subject.find(text, color))
+			subject.insert(text, color, FakeRenderedText(text, alive));
+	}
+};
+
+TEST_F(CRenderedTextCacheTest, findsRenderedString)
+{
+	EXPECT_EQ(nullptr, subject.find("Gold", YELLOW));
+
+	const FakeRenderedText & inserted = subject.insert("Gold", YELLOW, FakeRenderedText("Gold", alive));
+	const FakeRenderedText * found = subject.find("Gold", YELLOW);
+
+	ASSERT_NE(nullptr, found);
+	EXPECT_EQ(&inserted, found);
+	EXPECT_EQ("Gold", found->text);
+}
+
+TEST_F(CRenderedTextCacheTest, colorIsPartOfKey)
+{
+	render("Gold", YELLOW);
+
+	EXPECT_EQ(nullptr, subject.find("Gold", WHITE));
+	EXPECT_NE(nullptr, subject.find("Gold", YELLOW));
+}
+
+TEST_F(CRenderedTextCacheTest, leastRecentlyUsedStringIsDropped)
+{
+	render("Wood");
+	render("Ore");
+	render("Gold");
+	render("Wood"); // Ore is now least recently used
+	render("Gems");
+
+	EXPECT_EQ(3u, subject.size());
+	EXPECT_NE(nullptr, subject.find("Wood", YELLOW));
+	EXPECT_EQ(nullptr, subject.find("Ore", YELLOW));
+	EXPECT_NE(nullptr, subject.find("Gold", YELLOW));
+	EXPECT_NE(nullptr, subject.find("Gems", YELLOW));
+}
+
+TEST_F(CRenderedTextCacheTest, droppedStringIsDestroyed)
+{
+	render("Wood");
+	render("Ore");
+	render("Gold");
+	EXPECT_EQ(3, *alive);
+
+	render("Gems");
+	render("Mercury");
+	EXPECT_EQ(3, *alive);
+}
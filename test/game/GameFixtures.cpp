@@ -0,0 +1,58 @@
+/*
+ * GameFixtures.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "GameFixtures.h"
+
+#include "../lib/CGameState.h"
+#include "../lib/StartInfo.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+#include "../lib/rmg/CMapGenOptions.h"
+
+#include "../mock/mock_IGameCallback.h"
+
+RandomMapGame::RandomMapGame(int mapWidth, bool twoLevels, int players)
+{
+	StartInfo si;
+	si.mode = StartInfo::NEW_GAME;
+	si.seedToBeUsed = RANDOM_SEED;
+	si.mapGenOptions = std::make_shared<CMapGenOptions>();
+	si.mapGenOptions->setWidth(mapWidth);
+	si.mapGenOptions->setHeight(mapWidth);
+	si.mapGenOptions->setHasTwoLevels(twoLevels);
+	si.mapGenOptions->setPlayerCount(players);
+	for(int i = 0; i < players; i++)
+		si.mapGenOptions->setPlayerTypeForStandardPlayer(PlayerColor(i), EPlayerType::AI);
+
+	gs = make_unique<CGameState>();
+	cb = make_unique<GameCallbackMock>(gs.get());
+	IObjectInterface::cb = cb.get();
+	gs->init(&si);
+	mapSize = int3(gs->map->width, gs->map->height, gs->map->twoLevel ? 2 : 1);
+}
+
+RandomMapGame::~RandomMapGame()
+{
+	IObjectInterface::cb = nullptr;
+}
+
+void addTestArmy(CGHeroInstance & hero, int stacks, int bonusesPerStack)
+{
+	for(int i = 0; i < stacks; i++)
+	{
+		auto stack = new CStackInstance();
+		stack->count = 10 + i;
+		stack->experience = 100 * i;
+		for(int j = 0; j < bonusesPerStack; j++)
+			stack->addNewBonus(std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::STACKS_SPEED, Bonus::STACK_EXPERIENCE, j, j));
+		hero.putStack(SlotID(i), stack);
+	}
+}
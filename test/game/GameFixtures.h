@@ -0,0 +1,36 @@
+/*
+ * GameFixtures.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../lib/int3.h"
+
+class CGameState;
+class CGHeroInstance;
+class GameCallbackMock;
+
+/// New game on random map generated with fixed seed, all players are AI
+/// Map objects get callback with access to this game, as long as it exists
+/// Needs game data loaded by CVcmiTestConfig, like MapFormat.Random, tests using it can't run without it
+class RandomMapGame
+{
+public:
+	static const int RANDOM_SEED = 4242;
+
+	std::unique_ptr<CGameState> gs;
+	std::unique_ptr<GameCallbackMock> cb;
+	int3 mapSize; //in tiles, z is number of levels
+
+	RandomMapGame(int mapWidth, bool twoLevels, int players); //throws if game can't be created
+	~RandomMapGame();
+};
+
+/// Fills first slots of hero army, stack i has count 10 + i, experience 100 * i and bonuses of its own
+void addTestArmy(CGHeroInstance & hero, int stacks, int bonusesPerStack);
@@ -0,0 +1,73 @@
+/*
+ * mock_IGameCallback.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "StdInc.h"
+#include "../../lib/IGameCallback.h"
+
+/// Callback for map objects in tests that work directly on game state
+/// Gives read access to game state, game actions are ignored
+class GameCallbackMock : public IGameCallback
+{
+public:
+	GameCallbackMock(CGameState * GS)
+	{
+		gs = GS;
+	}
+
+	void commitPackage(CPackForClient * pack) override {}
+
+	void changeSpells(const CGHeroInstance * hero, bool give, const std::set<SpellID> &spells) override {}
+	bool removeObject(const CGObjectInstance * obj) override { return false; }
+	void setBlockVis(ObjectInstanceID objid, bool bv) override {}
+	void setOwner(const CGObjectInstance * objid, PlayerColor owner) override {}
+	void changePrimSkill(const CGHeroInstance * hero, PrimarySkill::PrimarySkill which, si64 val, bool abs) override {}
+	void changeSecSkill(const CGHeroInstance * hero, SecondarySkill which, int val, bool abs) override {}
+	void showBlockingDialog(BlockingDialog *iw) override {}
+	void showGarrisonDialog(ObjectInstanceID upobj, ObjectInstanceID hid, bool removableUnits) override {}
+	void showTeleportDialog(TeleportDialog *iw) override {}
+	void showThievesGuildWindow(PlayerColor player, ObjectInstanceID requestingObjId) override {}
+	void giveResource(PlayerColor player, Res::ERes which, int val) override {}
+	void giveResources(PlayerColor player, TResources resources) override {}
+	void giveCreatures(const CArmedInstance *objid, const CGHeroInstance * h, const CCreatureSet &creatures, bool remove) override {}
+	void takeCreatures(ObjectInstanceID objid, const std::vector<CStackBasicDescriptor> &creatures) override {}
+	bool changeStackCount(const StackLocation &sl, TQuantity count, bool absoluteValue) override { return false; }
+	bool changeStackType(const StackLocation &sl, const CCreature *c) override { return false; }
+	bool insertNewStack(const StackLocation &sl, const CCreature *c, TQuantity count) override { return false; }
+	bool eraseStack(const StackLocation &sl, bool forceRemoval) override { return false; }
+	bool swapStacks(const StackLocation &sl1, const StackLocation &sl2) override { return false; }
+	bool addToSlot(const StackLocation &sl, const CCreature *c, TQuantity count) override { return false; }
+	void tryJoiningArmy(const CArmedInstance *src, const CArmedInstance *dst, bool removeObjWhenFinished, bool allowMerging) override {}
+	bool moveStack(const StackLocation &src, const StackLocation &dst, TQuantity count) override { return false; }
+	void removeAfterVisit(const CGObjectInstance *object) override {}
+	void giveHeroNewArtifact(const CGHeroInstance *h, const CArtifact *artType, ArtifactPosition pos) override {}
+	void giveHeroArtifact(const CGHeroInstance *h, const CArtifactInstance *a, ArtifactPosition pos) override {}
+	void putArtifact(const ArtifactLocation &al, const CArtifactInstance *a) override {}
+	void removeArtifact(const ArtifactLocation &al) override {}
+	bool moveArtifact(const ArtifactLocation &al1, const ArtifactLocation &al2) override { return false; }
+	void synchronizeArtifactHandlerLists() override {}
+	void showCompInfo(ShowInInfobox * comp) override {}
+	void heroVisitCastle(const CGTownInstance * obj, const CGHeroInstance * hero) override {}
+	void stopHeroVisitCastle(const CGTownInstance * obj, const CGHeroInstance * hero) override {}
+	void startBattlePrimary(const CArmedInstance *army1, const CArmedInstance *army2, int3 tile, const CGHeroInstance *hero1, const CGHeroInstance *hero2, bool creatureBank, const CGTownInstance *town) override {}
+	void startBattleI(const CArmedInstance *army1, const CArmedInstance *army2, int3 tile, bool creatureBank) override {}
+	void startBattleI(const CArmedInstance *army1, const CArmedInstance *army2, bool creatureBank) override {}
+	void setAmount(ObjectInstanceID objid, ui32 val) override {}
+	bool moveHero(ObjectInstanceID hid, int3 dst, ui8 teleporting, bool transit, PlayerColor asker) override { return false; }
+	void giveHeroBonus(GiveBonus * bonus) override {}
+	void setMovePoints(SetMovePoints * smp) override {}
+	void setManaPoints(ObjectInstanceID hid, int val) override {}
+	void giveHero(ObjectInstanceID id, PlayerColor player) override {}
+	void changeObjPos(ObjectInstanceID objid, int3 newPos, ui8 flags) override {}
+	void sendAndApply(CPackForClient * info) override {}
+	void heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2) override {}
+	void changeFogOfWar(int3 center, ui32 radius, PlayerColor player, bool hide) override {}
+	void changeFogOfWar(std::unordered_set<int3, ShashInt3> &tiles, PlayerColor player, bool hide) override {}
+};
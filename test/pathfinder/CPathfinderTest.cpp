@@ -0,0 +1,257 @@
+/*
+ * CPathfinderTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/CGameState.h"
+#include "../lib/CPathfinder.h"
+#include "../lib/CRandomGenerator.h"
+#include "../lib/NetPacks.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/VCMI_Lib.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+#include "../lib/mapObjects/CObjectClassesHandler.h"
+#include "../lib/mapObjects/CQuest.h"
+
+#include "../game/GameFixtures.h"
+
+static const int TEST_CHANGES = 100;
+
+class CPathfinderTest : public ::testing::Test, public RandomMapGame
+{
+public:
+	CRandomGenerator rand;
+
+	CPathfinderTest()
+		: RandomMapGame(CMapHeader::MAP_SIZE_MIDDLE, true, 2)
+	{
+		rand.setSeed(RANDOM_SEED);
+	}
+
+	/// Takes one step along calculated paths, as movement of hero does
+	void moveHero(CPathsInfo & paths, CGHeroInstance * hero)
+	{
+		std::vector<const CGPathNode *> steps;
+		int3 pos = hero->getPosition(false);
+		for(int3 dir : {int3(-1, -1, 0), int3(0, -1, 0), int3(1, -1, 0), int3(-1, 0, 0), int3(1, 0, 0), int3(-1, 1, 0), int3(0, 1, 0), int3(1, 1, 0)})
+		{
+			const int3 tile = pos + dir;
+			if(!gs->map->isInTheMap(tile))
+				continue;
+
+			const CGPathNode * node = paths.getNode(tile, EPathfindingLayer::LAND);
+			if(node->turns == 0 && node->action == CGPathNode::NORMAL)
+				steps.push_back(node);
+		}
+
+		if(steps.empty())
+			return;
+
+		const CGPathNode * step = *RandomGeneratorUtil::nextItem(steps, rand);
+		const ui32 movement = step->moveRemains;
+
+		ChangeObjPos cop;
+		cop.objid = hero->id;
+		cop.nPos = CGHeroInstance::convertPosition(step->coord, true);
+		paths.invalidate(hero);
+		cop.applyGs(gs.get());
+		paths.invalidate(hero);
+
+		SetMovePoints smp;
+		smp.hid = hero->id;
+		smp.val = movement;
+		smp.applyGs(gs.get());
+		paths.invalidate(hero);
+	}
+
+	void removeObject(CPathsInfo & paths, const CGHeroInstance * hero)
+	{
+		std::vector<const CGObjectInstance *> objects;
+		for(auto & obj : gs->map->objects)
+		{
+			if(obj && obj->ID != Obj::HERO && obj->ID != Obj::TOWN)
+				objects.push_back(obj);
+		}
+
+		if(objects.empty())
+			return;
+
+		const CGObjectInstance * obj = *RandomGeneratorUtil::nextItem(objects, rand);
+		paths.invalidate(obj);
+		RemoveObject ro(obj->id);
+		ro.applyGs(gs.get());
+	}
+
+	void revealTiles(CPathsInfo & paths, const CGHeroInstance * hero)
+	{
+		const int3 center(rand.nextInt(mapSize.x - 1), rand.nextInt(mapSize.y - 1), rand.nextInt(mapSize.z - 1));
+
+		FoWChange fc;
+		fc.player = hero->tempOwner;
+		fc.mode = 1;
+		gs->getTilesInRange(fc.tiles, center, 4, boost::optional<PlayerColor>(), 0, int3::DIST_2D);
+
+		paths.invalidate(std::vector<int3>(fc.tiles.begin(), fc.tiles.end()));
+		fc.applyGs(gs.get());
+	}
+
+	/// Changes that don't affect paths of hero at all
+	void changeOtherHero(CPathsInfo & paths, const CGHeroInstance * hero)
+	{
+		for(auto other : gs->map->heroesOnMap)
+		{
+			if(other == hero)
+				continue;
+
+			SetMovePoints smp;
+			smp.hid = other->id;
+			smp.val = rand.nextInt(other->maxMovePoints(true));
+			smp.applyGs(gs.get());
+			paths.invalidate(other);
+			return;
+		}
+	}
+
+	bool isFreeTile(const int3 & tile) const
+	{
+		if(!gs->map->isInTheMap(tile))
+			return false;
+
+		const TerrainTile & tinfo = gs->map->getTile(tile);
+		return tinfo.terType != ETerrainType::WATER && tinfo.terType != ETerrainType::ROCK && !tinfo.blocked && !tinfo.visitable;
+	}
+
+	/// Puts new object on map, so it can be visited from first of given tiles where it fits
+	CGObjectInstance * addObject(si32 type, si32 subtype, const std::vector<int3> & visitableTiles)
+	{
+		auto handler = VLC->objtypeh->getHandlerFor(type, subtype);
+		CGObjectInstance * obj = handler->create(handler->getTemplates().front());
+
+		for(const int3 & tile : visitableTiles)
+		{
+			obj->pos = tile + obj->getVisitableOffset();
+			bool fits = isFreeTile(obj->visitablePos());
+			for(const int3 & blocked : obj->getBlockedPos())
+				fits = fits && isFreeTile(blocked);
+
+			if(fits)
+			{
+				obj->id = ObjectInstanceID(gs->map->objects.size());
+				gs->map->objects.push_back(obj);
+				gs->map->addBlockVisTiles(obj);
+				obj->initObj(gs->getRandomGenerator());
+				return obj;
+			}
+		}
+
+		delete obj;
+		return nullptr;
+	}
+
+	void expectSamePaths(const CPathsInfo & updated, const CPathsInfo & expected)
+	{
+		ASSERT_EQ(expected.nodes.size(), updated.nodes.size());
+		for(size_t i = 0; i < expected.nodes.size(); i++)
+		{
+			const CGPathNode & lhs = updated.nodes[i];
+			const CGPathNode & rhs = expected.nodes[i];
+
+			SCOPED_TRACE(rhs.coord.toString());
+			EXPECT_EQ(rhs.coord, lhs.coord);
+			EXPECT_EQ(rhs.layer, lhs.layer);
+			EXPECT_EQ(rhs.accessible, lhs.accessible);
+			EXPECT_EQ(rhs.action, lhs.action);
+			EXPECT_EQ(rhs.turns, lhs.turns);
+			EXPECT_EQ(rhs.moveRemains, lhs.moveRemains);
+			EXPECT_EQ(rhs.locked, lhs.locked);
+			EXPECT_EQ(rhs.theNodeBefore, lhs.theNodeBefore);
+
+			if(::testing::Test::HasFailure())
+				return;
+		}
+	}
+};
+
+TEST_F(CPathfinderTest, incrementalUpdateMatchesFullRecalculation)
+{
+	ASSERT_FALSE(gs->map->heroesOnMap.empty());
+	CGHeroInstance * hero = gs->map->heroesOnMap.front();
+
+	CPathsInfo updated(mapSize);
+	gs->updatePaths(hero, updated);
+
+	for(int i = 0; i < TEST_CHANGES; i++)
+	{
+		switch(rand.nextInt(3))
+		{
+		case 0:
+			moveHero(updated, hero);
+			break;
+		case 1:
+			removeObject(updated, hero);
+			break;
+		case 2:
+			revealTiles(updated, hero);
+			break;
+		case 3:
+			changeOtherHero(updated, hero);
+			break;
+		}
+
+		gs->updatePaths(hero, updated);
+
+		CPathsInfo expected(mapSize);
+		gs->calculatePaths(hero, expected);
+
+		SCOPED_TRACE(i);
+		expectSamePaths(updated, expected);
+		if(HasFailure())
+			return;
+	}
+}
+
+TEST_F(CPathfinderTest, keymasterVisitOpensDistantBorderGate)
+{
+	ASSERT_FALSE(gs->map->heroesOnMap.empty());
+	CGHeroInstance * hero = gs->map->heroesOnMap.front();
+	const int3 heroPos = hero->getPosition(false);
+	const si32 color = 0;
+
+	std::vector<int3> nextToHero, farFromHero;
+	for(int3 dir : {int3(-1, -1, 0), int3(0, -1, 0), int3(1, -1, 0), int3(-1, 0, 0), int3(1, 0, 0), int3(-1, 1, 0), int3(0, 1, 0), int3(1, 1, 0)})
+		nextToHero.push_back(heroPos + dir);
+	for(int i = 0; i < 100; i++)
+		farFromHero.push_back(int3(rand.nextInt(mapSize.x - 1), rand.nextInt(mapSize.y - 1), heroPos.z));
+	vstd::erase_if(farFromHero, [&](const int3 & tile)
+	{
+		return tile.dist2d(heroPos) < 10;
+	});
+
+	const CGObjectInstance * gate = addObject(Obj::BORDER_GATE, color, nextToHero);
+	const CGObjectInstance * tent = addObject(Obj::KEYMASTER, color, farFromHero);
+	ASSERT_TRUE(gate);
+	ASSERT_TRUE(tent);
+
+	CPathsInfo updated(mapSize);
+	gs->updatePaths(hero, updated);
+	EXPECT_EQ(CGPathNode::BLOCKING_VISIT, updated.getNode(gate->visitablePos(), EPathfindingLayer::LAND)->action);
+
+	//as sent by CGKeymasterTent::onHeroVisit
+	SetObjectProperty sop(tent->id, hero->tempOwner.getNum() + 101, color);
+	updated.invalidate(tent, sop.what);
+	sop.applyGs(gs.get());
+	gs->updatePaths(hero, updated);
+
+	CPathsInfo expected(mapSize);
+	gs->calculatePaths(hero, expected);
+	EXPECT_NE(CGPathNode::BLOCKING_VISIT, expected.getNode(gate->visitablePos(), EPathfindingLayer::LAND)->action);
+	expectSamePaths(updated, expected);
+
+	CGKeys::reset();
+}
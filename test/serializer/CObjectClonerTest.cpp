@@ -0,0 +1,113 @@
+/*
+ * CObjectClonerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/serializer/CObjectCloner.h"
+#include "../lib/serializer/CMemorySerializer.h"
+#include "../lib/serializer/Connection.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+#include "../lib/mapObjects/CGTownInstance.h"
+#include "../lib/mapObjects/MiscObjects.h"
+#include "../lib/CArtHandler.h"
+#include "../lib/CCreatureHandler.h"
+#include "../lib/CHeroHandler.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapping/CCampaignHandler.h"
+#include "../lib/rmg/CMapGenOptions.h"
+#include "../lib/StartInfo.h"
+
+#include "../game/GameFixtures.h"
+
+/// Binary form of object, copies are equal if they are serialized into same bytes
+template <typename T>
+static std::vector<ui8> serializeObject(const T * object)
+{
+	CConnectionBuffer buffer;
+	buffer.oser.smartPointerSerialization = true;
+	buffer.oser & object;
+	return buffer.getData();
+}
+
+class CObjectClonerTest : public ::testing::Test
+{
+public:
+	std::unique_ptr<CGHeroInstance> hero;
+
+	CObjectClonerTest()
+		: hero(make_unique<CGHeroInstance>())
+	{
+		hero->name = "Clone";
+		hero->exp = 1500;
+		hero->secSkills = {std::make_pair(SecondarySkill(SecondarySkill::LOGISTICS), 2), std::make_pair(SecondarySkill(SecondarySkill::WISDOM), 3)};
+		hero->pos = int3(10, 20, 1);
+		hero->tempOwner = PlayerColor(3);
+		hero->spells.insert(SpellID(SpellID::TOWN_PORTAL));
+		addTestArmy(*hero, 3, 1);
+
+		auto bonus = std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::PRIMARY_SKILL, Bonus::HERO_BASE_SKILL, 5, 0, PrimarySkill::ATTACK);
+		bonus->limiter = std::make_shared<RankRangeLimiter>(2, 5);
+		hero->addNewBonus(bonus);
+	}
+};
+
+TEST_F(CObjectClonerTest, heroSameAsMemorySerializer)
+{
+	auto expected = CMemorySerializer::deepCopy(*hero);
+	auto actual = CObjectCloner::deepCopy(*hero);
+
+	EXPECT_EQ(serializeObject(hero.get()), serializeObject(actual.get()));
+	EXPECT_EQ(serializeObject(expected.get()), serializeObject(actual.get()));
+}
+
+TEST_F(CObjectClonerTest, heroPointersLeadToCopies)
+{
+	auto copy = CObjectCloner::deepCopy(*hero);
+
+	ASSERT_EQ(hero->stacks.size(), copy->stacks.size());
+	for(auto & slot : copy->stacks)
+	{
+		EXPECT_NE(hero->stacks.at(slot.first), slot.second);
+		EXPECT_EQ(copy.get(), slot.second->armyObj);
+		EXPECT_EQ(hero->stacks.at(slot.first)->count, slot.second->count);
+	}
+
+	auto original = hero->getBonusList().front();
+	auto copied = copy->getBonusList().front();
+	EXPECT_NE(original, copied);
+	EXPECT_NE(original->limiter, copied->limiter);
+	ASSERT_TRUE(std::dynamic_pointer_cast<RankRangeLimiter>(copied->limiter) != nullptr);
+	EXPECT_EQ(5, std::dynamic_pointer_cast<RankRangeLimiter>(copied->limiter)->maxRank);
+}
+
+TEST_F(CObjectClonerTest, startInfoSameAsMemorySerializer)
+{
+	StartInfo si;
+	si.mode = StartInfo::NEW_GAME;
+	si.difficulty = 3;
+	si.mapname = "Maps/Test";
+	si.seedToBeUsed = 42;
+	for(int i = 0; i < 4; i++)
+	{
+		PlayerSettings & ps = si.playerInfos[PlayerColor(i)];
+		ps.color = PlayerColor(i);
+		ps.name = "Player " + boost::lexical_cast<std::string>(i);
+		ps.team = TeamID(i / 2);
+	}
+	si.mapGenOptions = std::make_shared<CMapGenOptions>();
+	si.mapGenOptions->setWidth(CMapHeader::MAP_SIZE_LARGE);
+	si.mapGenOptions->setHasTwoLevels(true);
+
+	auto expected = CMemorySerializer::deepCopy(si);
+	auto actual = CObjectCloner::deepCopy(si);
+
+	EXPECT_EQ(serializeObject(&si), serializeObject(actual.get()));
+	EXPECT_EQ(serializeObject(expected.get()), serializeObject(actual.get()));
+	EXPECT_NE(si.mapGenOptions, actual->mapGenOptions);
+}
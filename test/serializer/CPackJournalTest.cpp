@@ -0,0 +1,121 @@
+/*
+ * CPackJournalTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/serializer/CPackJournal.h"
+#include "../lib/serializer/Connection.h"
+#include "../lib/CGameState.h"
+#include "../lib/CPlayerState.h"
+#include "../lib/NetPacks.h"
+#include "../lib/VCMIDirs.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+
+#include "../game/GameFixtures.h"
+#include "../mock/mock_IGameCallback.h"
+
+class CPackJournalTest : public ::testing::Test, public RandomMapGame
+{
+public:
+	boost::filesystem::path path;
+	CConnectionBuffer buffer;
+	CGHeroInstance * hero;
+
+	CPackJournalTest()
+		: RandomMapGame(CMapHeader::MAP_SIZE_SMALL, false, 2),
+		path(VCMIDirs::get().userDataPath() / "CPackJournalTest.vjrn"),
+		hero(nullptr)
+	{
+		if(!gs->map->heroesOnMap.empty())
+			hero = gs->map->heroesOnMap.front();
+
+		// same settings as CGameHandler uses for packs sent to clients
+		buffer.addStdVecItems(gs.get());
+		buffer.sendStackInstanceByIds = true;
+	}
+
+	~CPackJournalTest()
+	{
+		boost::filesystem::remove(path);
+	}
+
+	void sendAndApply(CPackJournal & journal, CPackForClient * pack)
+	{
+		buffer.clear();
+		buffer.oser & pack;
+		journal.append(buffer.getData());
+		gs->apply(pack);
+	}
+
+	/// Records few packs that change hero and resources of its owner
+	void record()
+	{
+		CPackJournal journal(path, *cb);
+
+		ExchangeDialog ed;
+		ed.heroes = {hero, hero};
+		sendAndApply(journal, &ed);
+
+		SetResources sr;
+		sr.player = hero->tempOwner;
+		sr.res = gs->players.at(hero->tempOwner).resources;
+		sr.res[Res::GOLD] = 4242;
+		sendAndApply(journal, &sr);
+
+		SetMovePoints smp;
+		smp.hid = hero->id;
+		smp.val = 123;
+		sendAndApply(journal, &smp);
+
+		EXPECT_EQ(3, journal.size());
+	}
+
+	std::unique_ptr<CGameState> replay(ui32 & packs)
+	{
+		GameCallbackMock replayed(nullptr);
+		packs = CPackJournal::replay(path, replayed);
+		return std::unique_ptr<CGameState>(replayed.gameState());
+	}
+
+	const CGHeroInstance * replayedHero(const CGameState * replayed)
+	{
+		return dynamic_cast<const CGHeroInstance *>(replayed->map->objects.at(hero->id.getNum()).get());
+	}
+};
+
+TEST_F(CPackJournalTest, replayRebuildsState)
+{
+	ASSERT_TRUE(hero != nullptr);
+	record();
+
+	ui32 packs = 0;
+	auto replayed = replay(packs);
+
+	EXPECT_EQ(3, packs);
+	ASSERT_TRUE(replayedHero(replayed.get()) != nullptr);
+	EXPECT_EQ(hero->pos, replayedHero(replayed.get())->pos);
+	EXPECT_EQ(123, replayedHero(replayed.get())->movement);
+	EXPECT_EQ(4242, replayed->players.at(hero->tempOwner).resources[Res::GOLD]);
+}
+
+TEST_F(CPackJournalTest, incompletePackIsIgnored)
+{
+	ASSERT_TRUE(hero != nullptr);
+	const ui32 movement = hero->movement;
+	record();
+	boost::filesystem::resize_file(path, boost::filesystem::file_size(path) - 1);
+
+	ui32 packs = 0;
+	auto replayed = replay(packs);
+
+	EXPECT_EQ(2, packs);
+	EXPECT_EQ(movement, replayedHero(replayed.get())->movement);
+	EXPECT_EQ(4242, replayed->players.at(hero->tempOwner).resources[Res::GOLD]);
+}
@@ -0,0 +1,130 @@
+/*
+ * CSaveFileTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/serializer/BinarySerializer.h"
+#include "../lib/serializer/BinaryDeserializer.h"
+#include "../lib/VCMIDirs.h"
+
+class CSaveFileTest : public ::testing::Test
+{
+public:
+	boost::filesystem::path path;
+	std::vector<si32> data;
+	std::string text;
+
+	CSaveFileTest()
+		: path(VCMIDirs::get().userDataPath() / "CSaveFileTest.vsav"),
+		text("compressed")
+	{
+		for(int i = 0; i < 100000; i++)
+			data.push_back(i % 100);
+		boost::filesystem::remove(path);
+	}
+
+	~CSaveFileTest()
+	{
+		boost::filesystem::remove(path);
+	}
+
+	void save(CSaveFile::EMode mode)
+	{
+		CSaveFile save(path, mode);
+		save << data << text;
+		if(mode == CSaveFile::BACKGROUND)
+			save.finishInBackground();
+	}
+
+	void expectLoaded()
+	{
+		std::vector<si32> loadedData;
+		std::string loadedText;
+
+		CLoadFile load(path);
+		load >> loadedData >> loadedText;
+
+		EXPECT_EQ(data, loadedData);
+		EXPECT_EQ(text, loadedText);
+	}
+};
+
+TEST_F(CSaveFileTest, uncompressed)
+{
+	save(CSaveFile::UNCOMPRESSED);
+	expectLoaded();
+}
+
+TEST_F(CSaveFileTest, compressed)
+{
+	save(CSaveFile::UNCOMPRESSED);
+	const auto uncompressedSize = boost::filesystem::file_size(path);
+
+	save(CSaveFile::COMPRESSED);
+	EXPECT_LT(boost::filesystem::file_size(path) * 10, uncompressedSize);
+	expectLoaded();
+}
+
+TEST_F(CSaveFileTest, compressedReplacesOnlyFinishedFile)
+{
+	save(CSaveFile::UNCOMPRESSED);
+
+	{
+		CSaveFile unfinished(path, CSaveFile::COMPRESSED);
+		unfinished << std::vector<si32>() << std::string();
+		expectLoaded(); //other readers still see previous file
+	}
+
+	std::vector<si32> loadedData;
+	CLoadFile load(path);
+	load >> loadedData;
+	EXPECT_TRUE(loadedData.empty());
+}
+
+TEST_F(CSaveFileTest, background)
+{
+	save(CSaveFile::BACKGROUND);
+	expectLoaded(); //waits for background write
+}
+
+TEST_F(CSaveFileTest, backgroundReplacesOnlyFinishedFile)
+{
+	save(CSaveFile::UNCOMPRESSED);
+
+	{
+		CSaveFile unfinished(path, CSaveFile::BACKGROUND);
+		unfinished << std::vector<si32>() << std::string();
+	}
+	CSaveFile::waitForBackgroundWrites();
+	expectLoaded();
+}
+
+TEST_F(CSaveFileTest, backgroundReportsResult)
+{
+	std::vector<bool> results;
+	auto onWritten = [&results](bool written)
+	{
+		results.push_back(written);
+	};
+
+	{
+		CSaveFile save(path, CSaveFile::BACKGROUND);
+		save << data << text;
+		save.finishInBackground(onWritten);
+	}
+	{
+		CSaveFile save(path / "notADirectory" / "CSaveFileTest.vsav", CSaveFile::BACKGROUND);
+		save << data << text;
+		save.finishInBackground(onWritten);
+	}
+	CSaveFile::waitForBackgroundWrites();
+
+	EXPECT_EQ(std::vector<bool>({true, false}), results);
+	expectLoaded();
+}